@@ -241,3 +241,61 @@ BOOST_FIXTURE_TEST_CASE(Test5, Params) {
 
     BOOST_REQUIRE_EQUAL(resp.response_type(), pbnavitia::ResponseType::NO_SOLUTION);
 }
+
+/*
+ * Once the impacts are indexed, the traffic reports visit only the informed
+ * objects, the response must stay the same as when all the objects are scanned
+ */
+BOOST_AUTO_TEST_CASE(traffic_reports_with_impact_index) {
+    ed::builder b("20120614");
+    b.vj_with_network("network:R", "line:A", "11111111", "", true, "")
+            ("stop_area:stop1", 8*3600 + 10*60, 8*3600 + 11*60)("stop_area:stop2", 8*3600 + 20*60, 8*3600 + 21*60);
+    b.vj_with_network("network:K", "line:B", "11111111", "", true, "")
+            ("stop_area:stop3", 8*3600 + 10*60, 8*3600 + 11*60)("stop_area:stop4", 8*3600 + 20*60, 8*3600 + 21*60);
+    b.generate_dummy_basis();
+    b.finish();
+    b.data->pt_data->index();
+    b.data->build_uri();
+
+    using btp = boost::posix_time::time_period;
+    const auto publication = btp("20120614T000000"_dt, "20120620T000000"_dt);
+    b.impact(nt::RTLevel::Adapted).uri("on_line").publish(publication).application_periods(publication)
+            .severity(nt::disruption::Effect::SIGNIFICANT_DELAYS).on(nt::Type_e::Line, "line:A");
+    b.impact(nt::RTLevel::Adapted).uri("on_stop_area").publish(publication).application_periods(publication)
+            .severity(nt::disruption::Effect::SIGNIFICANT_DELAYS).on(nt::Type_e::StopArea, "stop_area:stop3");
+    b.impact(nt::RTLevel::Adapted).uri("on_network").publish(publication).application_periods(publication)
+            .severity(nt::disruption::Effect::SIGNIFICANT_DELAYS).on(nt::Type_e::Network, "network:K");
+    b.impact(nt::RTLevel::Adapted).uri("later").publish(btp("20120701T000000"_dt, "20120702T000000"_dt))
+            .application_periods(publication)
+            .severity(nt::disruption::Effect::SIGNIFICANT_DELAYS).on(nt::Type_e::Line, "line:B");
+
+    const auto now = "20120615T120000"_dt;
+    const auto& impact_index = b.data->pt_data->impact_index;
+    const auto& holder = b.data->pt_data->disruption_holder;
+    // not built yet, all the objects are scanned
+    BOOST_CHECK(! impact_index.can_answer(now, holder));
+    const auto scanned = navitia::disruption::traffic_reports(*b.data, now, 1, 10, 0, "", {});
+
+    b.data->build_raptor();
+    BOOST_REQUIRE(impact_index.can_answer(now, holder));
+    // out of the production period, the index cannot answer
+    BOOST_CHECK(! impact_index.can_answer("20140101T120000"_dt, holder));
+    BOOST_CHECK_EQUAL(impact_index.get_publishable_impacts(*b.data->pt_data->networks_map["network:K"],
+                                                           now).size(), 2);
+
+    const auto indexed = navitia::disruption::traffic_reports(*b.data, now, 1, 10, 0, "", {});
+    BOOST_CHECK_EQUAL(indexed.SerializeAsString(), scanned.SerializeAsString());
+    BOOST_REQUIRE_EQUAL(indexed.traffic_reports_size(), 2);
+    BOOST_CHECK_EQUAL(indexed.traffic_reports(0).network().uri(), "network:R");
+    BOOST_REQUIRE_EQUAL(indexed.traffic_reports(0).lines_size(), 1);
+    BOOST_CHECK_EQUAL(indexed.traffic_reports(0).lines(0).uri(), "line:A");
+    BOOST_CHECK_EQUAL(indexed.traffic_reports(1).network().uri(), "network:K");
+    BOOST_CHECK_EQUAL(indexed.traffic_reports(1).lines_size(), 0);
+    BOOST_REQUIRE_EQUAL(indexed.traffic_reports(1).stop_areas_size(), 1);
+    BOOST_CHECK_EQUAL(indexed.traffic_reports(1).stop_areas(0).uri(), "stop_area:stop3");
+
+    // with a filter, only the informed objects of the filtered network are kept
+    const auto filtered = navitia::disruption::traffic_reports(*b.data, now, 1, 10, 0, "network.uri=network:K", {});
+    BOOST_REQUIRE_EQUAL(filtered.traffic_reports_size(), 1);
+    BOOST_CHECK_EQUAL(filtered.traffic_reports(0).stop_areas_size(), 1);
+}
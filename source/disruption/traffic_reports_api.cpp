@@ -57,6 +57,18 @@ private:
     log4cplus::Logger logger;
 
     NetworkDisrupt& find_or_create(const type::Network* network);
+    type::Indexes query_in_network(const type::Type_e requested_type,
+                                   const type::Network* network,
+                                   const std::string& filter,
+                                   const std::vector<std::string>& forbidden_uris,
+                                   const type::Data& d);
+    void add_stop_area(const type::Network* network,
+                       const type::StopArea* stop_area,
+                       const boost::posix_time::ptime now);
+    void add_vehicle_journey(const type::Network* network,
+                             const type::VehicleJourney* vj,
+                             const boost::posix_time::ptime now);
+    void add_line(const type::Line* line, const boost::posix_time::ptime now);
     void add_stop_areas(const type::Indexes& network_idx,
                       const std::string& filter,
                       const std::vector<std::string>& forbidden_uris,
@@ -75,6 +87,11 @@ private:
                               const std::vector<std::string>& forbidden_uris,
                               const type::Data &d,
                               const boost::posix_time::ptime now);
+    void add_indexed_objects(const type::Indexes& network_idx,
+                             const std::string& filter,
+                             const std::vector<std::string>& forbidden_uris,
+                             const type::Data &d,
+                             const boost::posix_time::ptime now);
     void sort_disruptions();
 public:
     TrafficReport(): logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"))) {}
@@ -120,6 +137,50 @@ NetworkDisrupt& TrafficReport::find_or_create(const type::Network* network){
     return *it;
 }
 
+type::Indexes TrafficReport::query_in_network(const type::Type_e requested_type,
+                                              const type::Network* network,
+                                              const std::string& filter,
+                                              const std::vector<std::string>& forbidden_uris,
+                                              const type::Data& d) {
+    std::string new_filter = "network.uri=" + network->uri;
+    if (!filter.empty()) {
+        new_filter += " and " + filter;
+    }
+    try {
+        return ptref::make_query(requested_type, new_filter, forbidden_uris, d);
+    } catch (const ptref::parsing_error& parse_error) {
+        LOG4CPLUS_WARN(logger, "Disruption::query_in_network : Unable to parse filter "
+                       << parse_error.more);
+    } catch (const ptref::ptref_error& /*ptref_error*/) {
+        // that can arrive quite often if there is a filter, and
+        // it's quite normal. Imagine /line/metro1/traffic_reports
+        // for the network SNCF.
+    }
+    return {};
+}
+
+void TrafficReport::add_stop_area(const type::Network* network,
+                                  const type::StopArea* stop_area,
+                                  const boost::posix_time::ptime now) {
+    auto v = stop_area->get_publishable_messages(now);
+    for (const auto* stop_point: stop_area->stop_point_list) {
+        auto vsp = stop_point->get_publishable_messages(now);
+        v.insert(v.end(), vsp.begin(), vsp.end());
+    }
+    if (!v.empty()) {
+        NetworkDisrupt& dist = this->find_or_create(network);
+        auto find_predicate = [&](const std::pair<const type::StopArea*, DisruptionSet>& item) {
+            return item.first == stop_area;
+        };
+        auto it = boost::find_if(dist.stop_areas, find_predicate);
+        if (it == dist.stop_areas.end()) {
+            dist.stop_areas.push_back(std::make_pair(stop_area, DisruptionSet(v.begin(), v.end())));
+        } else {
+            it->second.insert(v.begin(), v.end());
+        }
+    }
+}
+
 void TrafficReport::add_stop_areas(const type::Indexes& network_idx,
                       const std::string& filter,
                       const std::vector<std::string>& forbidden_uris,
@@ -128,41 +189,9 @@ void TrafficReport::add_stop_areas(const type::Indexes& network_idx,
 
     for (auto idx : network_idx) {
         const auto* network = d.pt_data->networks[idx];
-        std::string new_filter = "network.uri=" + network->uri;
-        if (!filter.empty()) {
-            new_filter += " and " + filter;
-        }
-        type::Indexes stop_areas;
-
-       try {
-            stop_areas = ptref::make_query(type::Type_e::StopArea, new_filter, forbidden_uris, d);
-        } catch (const ptref::parsing_error& parse_error) {
-            LOG4CPLUS_WARN(logger, "Disruption::add_stop_areas : Unable to parse filter "
-                                + parse_error.more);
-        } catch (const ptref::ptref_error& /*ptref_error*/) {
-           // that can arrive quite often if there is a filter, and
-           // it's quite normal. Imagine /line/metro1/traffic_reports
-           // for the network SNCF.
-        }
+        const auto stop_areas = query_in_network(type::Type_e::StopArea, network, filter, forbidden_uris, d);
         for (auto stop_area_idx: stop_areas) {
-            const auto* stop_area = d.pt_data->stop_areas[stop_area_idx];
-            auto v = stop_area->get_publishable_messages(now);
-            for (const auto* stop_point: stop_area->stop_point_list) {
-                auto vsp = stop_point->get_publishable_messages(now);
-                v.insert(v.end(), vsp.begin(), vsp.end());
-            }
-            if (!v.empty()) {
-                NetworkDisrupt& dist = this->find_or_create(network);
-                auto find_predicate = [&](const std::pair<const type::StopArea*, DisruptionSet>& item) {
-                    return item.first == stop_area;
-                };
-                auto it = boost::find_if(dist.stop_areas, find_predicate);
-                if (it == dist.stop_areas.end()) {
-                    dist.stop_areas.push_back(std::make_pair(stop_area, DisruptionSet(v.begin(), v.end())));
-                } else {
-                    it->second.insert(v.begin(), v.end());
-                }
-            }
+            add_stop_area(network, d.pt_data->stop_areas[stop_area_idx], now);
         }
     }
 }
@@ -175,40 +204,33 @@ void TrafficReport::add_vehicle_journeys(const type::Indexes& network_idx,
 
     for (const auto idx : network_idx) {
         const auto* network = d.pt_data->networks[idx];
-        std::string new_filter = "network.uri=" + network->uri;
-        if (!filter.empty()) {
-            new_filter += " and " + filter;
-        }
-        type::Indexes vehicle_journeys;
-
-        try {
-            vehicle_journeys =
-                ptref::make_query(type::Type_e::VehicleJourney, new_filter, forbidden_uris, d);
-        } catch (const ptref::parsing_error& parse_error) {
-            LOG4CPLUS_WARN(logger, "Disruption::add_stop_areas : Unable to parse filter "
-                           << parse_error.more);
-        } catch (const ptref::ptref_error&) {
-        }
+        const auto vehicle_journeys =
+            query_in_network(type::Type_e::VehicleJourney, network, filter, forbidden_uris, d);
         for (const auto vj_idx: vehicle_journeys) {
-            const auto* vj = d.pt_data->vehicle_journeys[vj_idx];
-            auto impacts = vj->get_impacts();
-            boost::remove_erase_if(impacts, [&](const boost::shared_ptr<type::disruption::Impact>& impact) {
-                    if (! impact->disruption->is_publishable(now)) { return true; }
-                    if (impact->severity->effect != type::disruption::Effect::NO_SERVICE) { return true; }
-                    return false;
-                });
-            if (! impacts.empty()) {
-                NetworkDisrupt& dist = this->find_or_create(network);
-                auto find_predicate = [&](const std::pair<const type::VehicleJourney*, DisruptionSet>& item) {
-                    return item.first == vj;
-                };
-                auto it = boost::find_if(dist.vehicle_journeys, find_predicate);
-                if (it == dist.vehicle_journeys.end()) {
-                    dist.vehicle_journeys.push_back({vj, DisruptionSet(impacts.begin(), impacts.end())});
-                } else {
-                    it->second.insert(impacts.begin(), impacts.end());
-                }
-            }
+            add_vehicle_journey(network, d.pt_data->vehicle_journeys[vj_idx], now);
+        }
+    }
+}
+
+void TrafficReport::add_vehicle_journey(const type::Network* network,
+                                        const type::VehicleJourney* vj,
+                                        const boost::posix_time::ptime now) {
+    auto impacts = vj->get_impacts();
+    boost::remove_erase_if(impacts, [&](const boost::shared_ptr<type::disruption::Impact>& impact) {
+            if (! impact->disruption->is_publishable(now)) { return true; }
+            if (impact->severity->effect != type::disruption::Effect::NO_SERVICE) { return true; }
+            return false;
+        });
+    if (! impacts.empty()) {
+        NetworkDisrupt& dist = this->find_or_create(network);
+        auto find_predicate = [&](const std::pair<const type::VehicleJourney*, DisruptionSet>& item) {
+            return item.first == vj;
+        };
+        auto it = boost::find_if(dist.vehicle_journeys, find_predicate);
+        if (it == dist.vehicle_journeys.end()) {
+            dist.vehicle_journeys.push_back({vj, DisruptionSet(impacts.begin(), impacts.end())});
+        } else {
+            it->second.insert(impacts.begin(), impacts.end());
         }
     }
 }
@@ -241,22 +263,113 @@ void TrafficReport::add_lines(const std::string& filter,
         LOG4CPLUS_WARN(logger, "Disruption::add_lines : ptref : "  + ptref_error.more);
     }
     for(auto idx : line_list){
+        add_line(d.pt_data->lines[idx], now);
+    }
+}
+
+void TrafficReport::add_line(const type::Line* line, const boost::posix_time::ptime now) {
+    auto v = line->get_publishable_messages(now);
+    for(const auto* route: line->route_list){
+        auto vr = route->get_publishable_messages(now);
+        v.insert(v.end(), vr.begin(), vr.end());
+    }
+    if (!v.empty()){
+        NetworkDisrupt& dist = this->find_or_create(line->network);
+        auto find_predicate = [&](const std::pair<const type::Line*, DisruptionSet>& item) {
+            return line == item.first;
+        };
+        auto it = boost::find_if(dist.lines, find_predicate);
+        if(it == dist.lines.end()){
+            dist.lines.push_back(std::make_pair(line, DisruptionSet(v.begin(), v.end())));
+        }else{
+            it->second.insert(v.begin(), v.end());
+        }
+    }
+}
+
+/*
+ * Same as add_lines, add_stop_areas and add_vehicle_journeys, but only the
+ * objects informed by the impacts published now (read from the impact index)
+ * are visited, and the ptref queries of the networks without such objects are skipped.
+ * The objects are visited in the same order, so the result is the same.
+ */
+void TrafficReport::add_indexed_objects(const type::Indexes& network_idx,
+                                        const std::string& filter,
+                                        const std::vector<std::string>& forbidden_uris,
+                                        const type::Data& d,
+                                        const boost::posix_time::ptime now) {
+    namespace nd = type::disruption;
+    const auto& impact_index = d.pt_data->impact_index;
+
+    type::Indexes line_list;
+    try {
+        line_list = ptref::make_query(type::Type_e::Line, filter, forbidden_uris, d);
+    } catch(const ptref::parsing_error &parse_error) {
+        LOG4CPLUS_WARN(logger, "Disruption::add_lines : Unable to parse filter " + parse_error.more);
+    } catch(const ptref::ptref_error &ptref_error){
+        LOG4CPLUS_WARN(logger, "Disruption::add_lines : ptref : "  + ptref_error.more);
+    }
+    // the lines informed by the impacts published now, by network
+    std::map<const type::Network*, std::set<const type::Line*>> informed_lines;
+    auto get_informed_lines = [&](const type::Network* network) -> const std::set<const type::Line*>& {
+        auto it = informed_lines.find(network);
+        if (it != informed_lines.end()) { return it->second; }
+        auto& lines = informed_lines[network];
+        if (! network) { return lines; }
+        for (const auto& impact: impact_index.get_publishable_impacts(*network, now)) {
+            for (const auto& entity: impact->informed_entities) {
+                if (const auto* line = boost::get<type::Line*>(&entity)) {
+                    lines.insert(*line);
+                } else if (const auto* line_section = boost::get<nd::LineSection>(&entity)) {
+                    lines.insert(line_section->line);
+                } else if (const auto* route = boost::get<type::Route*>(&entity)) {
+                    lines.insert((*route)->line);
+                }
+            }
+        }
+        return lines;
+    };
+    for (const auto idx: line_list) {
         const auto* line = d.pt_data->lines[idx];
-        auto v = line->get_publishable_messages(now);
-        for(const auto* route: line->route_list){
-            auto vr = route->get_publishable_messages(now);
-            v.insert(v.end(), vr.begin(), vr.end());
+        if (get_informed_lines(line->network).count(line)) {
+            add_line(line, now);
         }
-        if (!v.empty()){
-            NetworkDisrupt& dist = this->find_or_create(line->network);
-            auto find_predicate = [&](const std::pair<const type::Line*, DisruptionSet>& item) {
-                return line == item.first;
-            };
-            auto it = boost::find_if(dist.lines, find_predicate);
-            if(it == dist.lines.end()){
-                dist.lines.push_back(std::make_pair(line, DisruptionSet(v.begin(), v.end())));
-            }else{
-                it->second.insert(v.begin(), v.end());
+    }
+
+    for (const auto idx: network_idx) {
+        const auto* network = d.pt_data->networks[idx];
+        std::set<type::idx_t> stop_areas;
+        std::set<type::idx_t> vehicle_journeys;
+        for (const auto& impact: impact_index.get_publishable_impacts(*network, now)) {
+            for (const auto& entity: impact->informed_entities) {
+                if (const auto* stop_area = boost::get<type::StopArea*>(&entity)) {
+                    stop_areas.insert((*stop_area)->idx);
+                } else if (const auto* stop_point = boost::get<type::StopPoint*>(&entity)) {
+                    if ((*stop_point)->stop_area) { stop_areas.insert((*stop_point)->stop_area->idx); }
+                } else if (const auto* meta_vj = boost::get<type::MetaVehicleJourney*>(&entity)) {
+                    if (impact->severity->effect != nd::Effect::NO_SERVICE) { continue; }
+                    (*meta_vj)->for_all_vjs([&](const type::VehicleJourney& vj) {
+                        vehicle_journeys.insert(vj.idx);
+                    });
+                }
+            }
+        }
+        if (! stop_areas.empty()) {
+            const auto network_stop_areas =
+                query_in_network(type::Type_e::StopArea, network, filter, forbidden_uris, d);
+            for (const auto stop_area_idx: stop_areas) {
+                if (network_stop_areas.count(stop_area_idx)) {
+                    add_stop_area(network, d.pt_data->stop_areas[stop_area_idx], now);
+                }
+            }
+        }
+        if (! vehicle_journeys.empty()) {
+            const auto network_vjs =
+                query_in_network(type::Type_e::VehicleJourney, network, filter, forbidden_uris, d);
+            for (const auto vj_idx: vehicle_journeys) {
+                if (network_vjs.count(vj_idx)) {
+                    add_vehicle_journey(network, d.pt_data->vehicle_journeys[vj_idx], now);
+                }
             }
         }
     }
@@ -295,9 +408,13 @@ void TrafficReport::disruptions_list(const std::string& filter,
     type::Indexes network_idx = ptref::make_query(type::Type_e::Network, filter,
                                                              forbidden_uris, d);
     add_networks(network_idx, d, now);
-    add_lines(filter, forbidden_uris, d, now);
-    add_stop_areas(network_idx, filter, forbidden_uris, d, now);
-    add_vehicle_journeys(network_idx, filter, forbidden_uris, d, now);
+    if (d.pt_data->impact_index.can_answer(now, d.pt_data->disruption_holder)) {
+        add_indexed_objects(network_idx, filter, forbidden_uris, d, now);
+    } else {
+        add_lines(filter, forbidden_uris, d, now);
+        add_stop_areas(network_idx, filter, forbidden_uris, d, now);
+        add_vehicle_journeys(network_idx, filter, forbidden_uris, d, now);
+    }
     sort_disruptions();
 }
 
@@ -243,6 +243,11 @@ int main(int argc, char * argv[])
     LOG4CPLUS_INFO(logger, "fare tickets: " << data.fare->fare_map.size());
     LOG4CPLUS_INFO(logger, "fare transitions: " << data.fare->nb_transitions());
     LOG4CPLUS_INFO(logger, "fare od: " << data.fare->od_tickets.size());
+
+    // saved with the data, kraken will not have to compute it at load
+    LOG4CPLUS_INFO(logger, "Building dataRaptor ...");
+    data.build_raptor();
+
     LOG4CPLUS_INFO(logger, "Begin to save ...");
 
     start = pt::microsec_clock::local_time();
@@ -33,6 +33,9 @@ www.navitia.io
 #include <boost/foreach.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/optional.hpp>
+#include <map>
+#include <tuple>
 
 #include "type/datetime.h"
 
@@ -124,14 +127,84 @@ std::string comp_to_string(const Comp_e comp) {
     }
 }
 
+// the key of all that matters in a label for the transitions and the tickets to come
+typedef std::tuple<const std::string&, int, const std::string&, const std::string&, const std::string&,
+                   int, int, Ticket::ticket_type, bool, bool, const std::string&, const std::string&> LabelKey;
+
+static LabelKey label_key(const Label& label) {
+    static const std::string empty_string;
+    const Ticket* last = label.tickets.empty() ? nullptr : &label.tickets.back();
+    return LabelKey(label.stop_area, label.zone, label.mode, label.line, label.network,
+                    label.nb_changes, label.start_time, label.current_type, label.cost.undefined,
+                    last != nullptr, last ? last->key : empty_string, last ? last->caption : empty_string);
+}
+
+// Two labels with the same key have the same future, we only keep the cheapest
+// (the first one if they cost the same, as the final selection does)
+static void remove_dominated(std::vector<Label>& labels) {
+    if (labels.size() < 2) { return; }
+    std::map<LabelKey, size_t> best_by_key;
+    for (size_t i = 0; i < labels.size(); ++i) {
+        const auto it = best_by_key.emplace(label_key(labels[i]), i);
+        if (it.second) { continue; }
+        const Label& best = labels[it.first->second];
+        if (std::make_pair(labels[i].nb_undefined_sub_cost, labels[i].cost.value)
+                < std::make_pair(best.nb_undefined_sub_cost, best.cost.value)) {
+            it.first->second = i;
+        }
+    }
+    if (best_by_key.size() == labels.size()) { return; }
+
+    std::vector<bool> kept(labels.size(), false);
+    for (const auto& key_idx: best_by_key) { kept[key_idx.second] = true; }
+    std::vector<Label> res;
+    res.reserve(best_by_key.size());
+    for (size_t i = 0; i < labels.size(); ++i) {
+        if (kept[i]) { res.push_back(std::move(labels[i])); }
+    }
+    labels = std::move(res);
+}
+
+Fare::TransitionIndex Fare::index_transitions() const {
+    TransitionIndex transitions(boost::num_vertices(g));
+    BOOST_FOREACH(edge_t e, boost::edges(g)) {
+        const Transition& transition = g[e];
+        const DateTicket* date_ticket = nullptr;
+        if (transition.ticket_key != "") {
+            auto it = fare_map.find(transition.ticket_key);
+            if (it != fare_map.end()) { date_ticket = &it->second; }
+        }
+        transitions[boost::source(e, g)].push_back({boost::target(e, g), &transition, date_ticket});
+    }
+    return transitions;
+}
+
 results Fare::compute_fare(const routing::Path& path) const {
-    results res;
-    int nb_nodes = boost::num_vertices(g);
+    if (boost::num_vertices(g) < 2) {
+        LOG4CPLUS_TRACE(logger, "no fare data loaded, cannot compute fare");
+        return results();
+    }
+    return compute_fare(path, index_transitions());
+}
 
-    if (nb_nodes < 2) {
+std::vector<results> Fare::compute_fares(const std::vector<routing::Path>& paths) const {
+    if (boost::num_vertices(g) < 2) {
         LOG4CPLUS_TRACE(logger, "no fare data loaded, cannot compute fare");
-        return res;
+        return std::vector<results>(paths.size());
     }
+    const auto transitions = index_transitions();
+    std::vector<results> res;
+    res.reserve(paths.size());
+    for (const auto& path: paths) {
+        res.push_back(compute_fare(path, transitions));
+    }
+    return res;
+}
+
+results Fare::compute_fare(const routing::Path& path, const TransitionIndex& transitions) const {
+    results res;
+    const size_t nb_nodes = transitions.size();
+
     std::vector< std::vector<Label> > labels(nb_nodes);
     // Start label
     labels[0].push_back(Label());
@@ -145,33 +218,45 @@ results Fare::compute_fare(const routing::Path& path) const {
 
         SectionKey section_key(item, section_idx++);
 
+        // the states compatible with the section
+        std::vector<bool> valid_states(nb_nodes);
+        for (size_t v = 0; v < nb_nodes; ++v) {
+            valid_states[v] = valid(g[v], section_key);
+        }
+
         std::vector<std::vector<Label>> new_labels(nb_nodes);
         try {
-            BOOST_FOREACH(edge_t e, boost::edges(g)) {
-                vertex_t u = boost::source(e,g);
-                vertex_t v = boost::target(e,g);
-                if (! valid(g[v], section_key))
-                    continue;
-
-                for (const Label& label: labels[u]) {
-                    Ticket ticket;
-                    const Transition& transition = g[e];
-                    if (valid(g[u], label) && transition.valid(section_key, label)) {
-                        if (transition.ticket_key != "") {
-                            bool ticket_found = false; //TODO refactor this, optional is way better
-                            auto it = fare_map.find(transition.ticket_key);
-                            try {
-                                if (it != fare_map.end()) {
-                                    ticket = it->second.get_fare(section_key.date);
-                                    ticket_found = true;
+            for (size_t u = 0; u < nb_nodes; ++u) {
+                if (labels[u].empty()) { continue; }
+                for (const IndexedTransition& indexed_transition: transitions[u]) {
+                    const vertex_t v = indexed_transition.target;
+                    if (! valid_states[v])
+                        continue;
+
+                    const Transition& transition = *indexed_transition.transition;
+                    // the ticket only depends on the date of the section, it is searched once
+                    boost::optional<Ticket> transition_ticket;
+                    for (const Label& label: labels[u]) {
+                        if (! (valid(g[u], label) && transition.valid(section_key, label))) {
+                            continue;
+                        }
+                        if (! transition_ticket) {
+                            if (transition.ticket_key != "") {
+                                try {
+                                    if (indexed_transition.date_ticket) {
+                                        transition_ticket = indexed_transition.date_ticket->get_fare(section_key.date);
+                                    }
                                 }
-                            }
-                            catch(no_ticket) { //the ticket_found bool is still false
-                            }
-                            if (! ticket_found) {
-                                ticket = make_default_ticket();
+                                catch(no_ticket) { //the transition_ticket is still empty
+                                }
+                                if (! transition_ticket) {
+                                    transition_ticket = make_default_ticket();
+                                }
+                            } else {
+                                transition_ticket = Ticket();
                             }
                         }
+                        Ticket ticket = *transition_ticket;
                         if (transition.global_condition == Transition::GlobalCondition::exclusive)
                             throw ticket;
                         else if(transition.global_condition == Transition::GlobalCondition::with_changes) {
@@ -219,7 +304,9 @@ results Fare::compute_fare(const routing::Path& path) const {
             }
         }
         labels = std::move(new_labels);
-
+        for (auto& node_labels: labels) {
+            remove_dominated(node_labels);
+        }
     }
 
     // We look for the cheapest label
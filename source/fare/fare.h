@@ -346,6 +346,9 @@ struct Fare {
     /// Retourne une liste de billets à acheter
     results compute_fare(const routing::Path& path) const;
 
+    /// Prices all the journeys of a response, the transitions are indexed only once
+    std::vector<results> compute_fares(const std::vector<routing::Path>& paths) const;
+
     template<class Archive> void save(Archive & ar, const unsigned int) const {
         ar & fare_map & od_tickets & g;
     }
@@ -359,6 +362,18 @@ struct Fare {
 
     size_t nb_transitions() const;
 private:
+    /// A transition from a given state, with its fare resolved
+    struct IndexedTransition {
+        vertex_t target;
+        const Transition* transition;
+        const DateTicket* date_ticket; //< nullptr if the ticket is not in fare_map
+    };
+    /// The transitions by source state, in the order of the graph
+    typedef std::vector<std::vector<IndexedTransition>> TransitionIndex;
+    TransitionIndex index_transitions() const;
+
+    results compute_fare(const routing::Path& path, const TransitionIndex& transitions) const;
+
     /// Retourne le ticket OD qui va bien ou lève une exception no_ticket si on ne trouve pas
     DateTicket get_od(const Label& label, const SectionKey& section) const;
 
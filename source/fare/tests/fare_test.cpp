@@ -444,6 +444,36 @@ BOOST_FIXTURE_TEST_CASE(metro_rer_bus, fare_load_fixture) {
     BOOST_CHECK_EQUAL(res.tickets.at(1).value, 170);
 }
 
+// all the journeys of a response are priced together, as they would be one by one
+BOOST_FIXTURE_TEST_CASE(compute_fares_of_response, fare_load_fixture) {
+    std::vector<navitia::routing::Path> paths;
+    paths.push_back(string_to_path({"439;59465;100110008:8;8739303;2011|12|01;16|07;16|34;1;1;Metro",
+                                    "436;8739303;800:C;8739315;2011|12|01;16|41;17|12;1;4;RapidTransit",
+                                    "285;8739315;056356006:H;2:212;2011|12|01;17|17;17|19;4;4;Bus"}));
+    paths.push_back(string_to_path({"ratp;8711388;8775890;FILGATO-2;2011|07|01;04|40;04|50;4;1;rapidtransit",
+                                    "ratp;paris;FILNav31;FILGATO-2;2011|07|01;04|40;04|50;1;1;metro"}));
+    paths.push_back(navitia::routing::Path());
+
+    const auto fares = f.compute_fares(paths);
+    BOOST_REQUIRE_EQUAL(fares.size(), paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const auto expected = f.compute_fare(paths[i]);
+        BOOST_CHECK_EQUAL(fares[i].total, expected.total);
+        BOOST_CHECK_EQUAL(fares[i].not_found, expected.not_found);
+        BOOST_REQUIRE_EQUAL(fares[i].tickets.size(), expected.tickets.size());
+        for (size_t t = 0; t < expected.tickets.size(); ++t) {
+            BOOST_CHECK_EQUAL(fares[i].tickets[t].key, expected.tickets[t].key);
+            BOOST_CHECK_EQUAL(fares[i].tickets[t].sections.size(), expected.tickets[t].sections.size());
+        }
+    }
+    BOOST_REQUIRE_EQUAL(fares[0].tickets.size(), 2);
+    BOOST_CHECK_EQUAL(fares[0].tickets.at(0).value, 320);
+    BOOST_CHECK_EQUAL(fares[0].tickets.at(1).value, 170);
+    BOOST_REQUIRE_EQUAL(fares[1].tickets.size(), 1);
+    BOOST_CHECK_EQUAL(fares[1].tickets.at(0).value, 395);
+    BOOST_CHECK(fares[2].tickets.empty());
+}
+
     // Jeux de tests rajoutés par le STIF
 BOOST_FIXTURE_TEST_CASE(stif_test_case_1, fare_load_fixture) {
     // Essais avec noctilien
@@ -75,8 +75,10 @@ namespace navitia {
             std::string get_range_postal_codes();
             std::string postal_codes_to_string() const;
             template<class Archive> void serialize(Archive & ar, const unsigned int ) {
+                // main_stop_areas and odt_stop_points are links to the pt_data,
+                // managed by Data::CrossReferences
                 ar & idx & level & from_original_dataset & insee
-                        & name & uri & coord & admin_list & main_stop_areas & label & odt_stop_points & postal_codes;
+                        & name & uri & coord & admin_list & label & postal_codes;
             }
         };
     }
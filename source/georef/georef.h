@@ -220,6 +220,7 @@ struct GeoRef {
     std::map<std::string, POIType*> poitype_map;
     std::vector<POI*> pois;
     std::map<std::string, POI*> poi_map;
+    // the proximity lists are serialized by Data, as flat arrays in a data file
     proximitylist::ProximityList<type::idx_t> poi_proximity_list;
     std::vector<Way*> ways;
     std::map<std::string, nt::idx_t> way_map;
@@ -234,7 +235,7 @@ struct GeoRef {
     /// Indexe sur les pois
     autocomplete::Autocomplete<unsigned int> fl_poi = autocomplete::Autocomplete<unsigned int>(navitia::type::Type_e::POI);
 
-    /// Indexe tous les nœuds
+    /// Indexe tous les nœuds (serialized by Data, as the other proximity lists)
     proximitylist::ProximityList<vertex_t> pl;
 
     /// for all stop_point, we store it's projection on each graph
@@ -265,18 +266,18 @@ struct GeoRef {
     void init();
 
     template<class Archive> void save(Archive & ar, const unsigned int) const {
-        ar & ways & way_map & graph & offsets & fl_admin & fl_way & pl & projected_stop_points
+        ar & ways & way_map & graph & offsets & fl_admin & fl_way & projected_stop_points
                 & admins & admin_map &  pois & fl_poi & poitypes & poitype_map & poi_map & synonyms
-                & ghostwords & poi_proximity_list & nb_vertex_by_mode;
+                & ghostwords & nb_vertex_by_mode;
     }
 
     template<class Archive> void load(Archive & ar, const unsigned int) {
         // La désérialisation d'une boost adjacency list ne vide pas le graphe
         // On avait donc une fuite de mémoire
         graph.clear();
-        ar & ways & way_map & graph & offsets & fl_admin & fl_way & pl & projected_stop_points
+        ar & ways & way_map & graph & offsets & fl_admin & fl_way & projected_stop_points
                 & admins & admin_map & pois & fl_poi & poitypes & poitype_map & poi_map & synonyms
-                & ghostwords & poi_proximity_list & nb_vertex_by_mode;
+                & ghostwords & nb_vertex_by_mode;
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
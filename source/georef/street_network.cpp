@@ -68,6 +68,19 @@ StreetNetwork::StreetNetwork(const GeoRef &geo_ref) :
     direct_path_finder(geo_ref)
 {}
 
+StreetNetwork::StreetNetwork(const GeoRef& geo_ref, StreetNetwork&& previous) :
+    geo_ref(geo_ref),
+    departure_path_finder(geo_ref, std::move(previous.departure_path_finder)),
+    arrival_path_finder(geo_ref, std::move(previous.arrival_path_finder)),
+    direct_path_finder(geo_ref, std::move(previous.direct_path_finder))
+{}
+
+void StreetNetwork::set_deadline(const Deadline& deadline) {
+    departure_path_finder.deadline = deadline;
+    arrival_path_finder.deadline = deadline;
+    direct_path_finder.deadline = deadline;
+}
+
 void StreetNetwork::init(const type::EntryPoint& start, boost::optional<const type::EntryPoint&> end) {
     departure_path_finder.init(start.coordinates, start.streetnetwork_params.mode, start.streetnetwork_params.speed_factor);
 
@@ -171,6 +184,16 @@ StreetNetwork::get_direct_path(const type::EntryPoint& origin, const type::Entry
 
 PathFinder::PathFinder(const GeoRef& gref) : geo_ref(gref) {}
 
+PathFinder::PathFinder(const GeoRef& gref, PathFinder&& previous) :
+    geo_ref(gref), deadline(previous.deadline) {
+    // predecessors are not cleaned at init, so we only keep them for a
+    // graph of the same size
+    if (previous.distances.size() == boost::num_vertices(gref.graph)) {
+        distances = std::move(previous.distances);
+        predecessors = std::move(previous.predecessors);
+    }
+}
+
 void PathFinder::init(const type::GeographicalCoord& start_coord, nt::Mode_e mode, const float speed_factor) {
     computation_launch = false;
     // we look for the nearest edge from the start coordinate
@@ -32,6 +32,7 @@ www.navitia.io
 #include "georef.h"
 #include "routing/raptor_utils.h"
 #include "type/time_duration.h"
+#include "type/deadline.h"
 #include <boost/graph/filtered_graph.hpp>
 #include <boost/graph/two_bit_color_map.hpp>
 #include <boost/graph/dijkstra_shortest_paths.hpp>
@@ -96,6 +97,22 @@ struct TransportationModeFilter {
     }
 };
 
+/// forwards the events to Visitor and checks the deadline every 1024 examined vertices
+template<typename Visitor>
+struct deadline_visitor: public Visitor {
+    const Deadline& deadline;
+    size_t nb_examined = 0;
+    deadline_visitor(const Visitor& visitor, const Deadline& deadline): Visitor(visitor), deadline(deadline) {}
+
+    template<typename G>
+    void examine_vertex(typename boost::graph_traits<G>::vertex_descriptor u, const G& g) {
+        if ((++nb_examined & 1023) == 0) {
+            deadline.check("street network");
+        }
+        Visitor::examine_vertex(u, g);
+    }
+};
+
 struct PathFinder {
     const GeoRef & geo_ref;
 
@@ -118,7 +135,12 @@ struct PathFinder {
     /// Predecessors array for the Dijkstra
     std::vector<vertex_t> predecessors;
 
+    /// the dijkstra is aborted with a DeadlineExpired once it is exceeded
+    Deadline deadline;
+
     PathFinder(const GeoRef& geo_ref);
+    /// reuses the buffers of previous (built on another geo_ref) if the graph has the same size
+    PathFinder(const GeoRef& geo_ref, PathFinder&& previous);
 
     /**
      *  Update the structure for a given starting point and transportation mode
@@ -160,7 +182,7 @@ struct PathFinder {
                                                std::less<navitia::time_duration>(),
                                                SpeedDistanceCombiner(speed_factor), //we multiply the edge duration by a speed factor
                                                navitia::seconds(0),
-                                               visitor,
+                                               deadline_visitor<Visitor>(visitor, deadline),
                                                color
                                                );
     }
@@ -202,9 +224,13 @@ private:
 /** Structure managing the computation on the streetnetwork */
 struct StreetNetwork {
     StreetNetwork(const GeoRef& geo_ref);
+    /// rebinds previous to geo_ref, reusing its buffers if possible
+    StreetNetwork(const GeoRef& geo_ref, StreetNetwork&& previous);
 
     void init(const type::EntryPoint& start_coord, boost::optional<const type::EntryPoint&> end_coord = {});
 
+    void set_deadline(const Deadline& deadline);
+
     bool departure_launched() const;
     bool arrival_launched() const;
 
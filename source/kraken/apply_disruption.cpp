@@ -225,8 +225,10 @@ struct add_impacts_visitor : public apply_impacts_visitor {
          * In this loop, we'are going to find all Vjs that are impacted by the closure of the stop point
          * and the validity pattern of the new Vj to be created in the next step
          *
+         * Only the vjs stopping at the stop point can be impacted
+         *
          * */
-        for (const auto* vj: pt_data.vehicle_journeys) {
+        for (const auto* vj: pt_data.get_vehicle_journeys(*stop_point)) {
 
             /*
              * Pre-filtering by validity pattern, which allows us to check if the vj is impacted quickly
@@ -460,9 +462,19 @@ struct delete_impacts_visitor : public apply_impacts_visitor {
             }
             return false;
         };
-        for (auto& mvj: pt_data.meta_vjs) {
+        // only the meta vjs stopping at the stop point can be impacted, we
+        // collect them first as deleting the impact creates new vjs
+        std::vector<nt::MetaVehicleJourney*> mvjs;
+        for (const auto* vj: pt_data.get_vehicle_journeys(*stop_point)) {
+            mvjs.push_back(vj->meta_vj);
+        }
+        std::sort(mvjs.begin(), mvjs.end(), [](const nt::MetaVehicleJourney* a, const nt::MetaVehicleJourney* b) {
+            return a->idx < b->idx;
+        });
+        mvjs.erase(std::unique(mvjs.begin(), mvjs.end()), mvjs.end());
+        for (auto* mvj: mvjs) {
             if (std::any_of(std::begin(mvj->impacted_by), std::end(mvj->impacted_by), find_impact)) {
-                (*this)(mvj.get());
+                (*this)(mvj);
             };
         }
     }
@@ -517,6 +529,7 @@ void delete_disruption(const std::string& disruption_id,
         for (const auto& impact : disruption->get_impacts()) {
             delete_impact(impact, pt_data, meta);
         }
+        pt_data.impact_index.remove(*disruption, holder);
     }
     holder.clean_weak_impacts();
     LOG4CPLUS_DEBUG(log, "disruption " << disruption_id << " deleted");
@@ -528,6 +541,7 @@ void apply_disruption(const type::disruption::Disruption& disruption, nt::PT_Dat
     for (const auto& impact: disruption.get_impacts()) {
         apply_impact(impact, pt_data, meta);
     }
+    pt_data.impact_index.add(disruption, pt_data);
 }
 
 } // namespace navitia
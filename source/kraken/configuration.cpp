@@ -31,6 +31,7 @@ www.navitia.io
 #include "configuration.h"
 #include "utils/exception.h"
 #include <fstream>
+#include <algorithm>
 #include <boost/optional.hpp>
 
 namespace po = boost::program_options;
@@ -53,6 +54,18 @@ po::options_description get_options_description(const boost::optional<std::strin
          "name of the instance")
 
         ("GENERAL.nb_threads", po::value<int>()->default_value(1), "number of workers threads")
+        ("GENERAL.nb_light_threads", po::value<int>()->default_value(1),
+         "number of workers threads dedicated to the cheap requests (places, pt_objects, metadatas...)")
+        ("GENERAL.max_queue_size", po::value<int>()->default_value(0),
+         "maximum number of requests waiting for a worker, by lane, the others are rejected (0: no limit)")
+        ("GENERAL.max_queue_age", po::value<int>()->default_value(0),
+         "maximum time in ms a request can wait for a worker before being rejected (0: no limit)")
+        ("GENERAL.request_timeout", po::value<int>()->default_value(0),
+         "time in ms after which a request is aborted (0: no limit)")
+        ("GENERAL.journeys_timeout", po::value<int>(),
+         "time in ms after which a journeys or isochrone request is aborted, request_timeout if not set (0: no limit)")
+        ("GENERAL.ptref_timeout", po::value<int>(),
+         "time in ms after which a ptref request is aborted, request_timeout if not set (0: no limit)")
         ("GENERAL.is_realtime_enabled", po::value<bool>()->default_value(false),
                                         "enable loading of realtime data")
         ("GENERAL.kirin_timeout", po::value<int>()->default_value(60000),
@@ -64,6 +77,16 @@ po::options_description get_options_description(const boost::optional<std::strin
              po::value<bool>()->default_value(*display_contributors) : po::value<bool>()->default_value(false),
          "display all contributors in feed publishers")
         ("GENERAL.raptor_cache_size", po::value<int>()->default_value(10), "maximum number of stored raptor caches")
+        ("GENERAL.raptor_cache_warmup_days", po::value<int>()->default_value(2),
+         "number of days, from today, of the raptor caches built before publishing new data (0 to disable)")
+        ("GENERAL.raptor_cache_warmup_levels", po::value<std::vector<std::string>>(),
+         "realtime levels (theoric, adapted, realtime) of the warmed up raptor caches, theoric and realtime by default")
+        ("GENERAL.raptor_cache_warmup_wheelchair", po::value<bool>()->default_value(true),
+         "also warm up the raptor caches of the wheelchair requests")
+        ("GENERAL.response_cache_size", po::value<int>()->default_value(0),
+         "maximum number of responses kept to answer the identical requests (0 to disable)")
+        ("GENERAL.response_cache_time_bucket", po::value<int>()->default_value(60),
+         "time in seconds during which a cached response can be served again")
 
         ("BROKER.host", po::value<std::string>()->default_value("localhost"), "host of rabbitmq")
         ("BROKER.port", po::value<int>()->default_value(5672), "port of rabbitmq")
@@ -162,6 +185,20 @@ int Configuration::broker_sleeptime() const {
     return vm["BROKER.sleeptime"].as<int>();
 }
 
+size_t Configuration::response_cache_size() const{
+    if (! vm.count("GENERAL.response_cache_size")) {
+        return 0;
+    }
+    return size_t(std::max(0, vm["GENERAL.response_cache_size"].as<int>()));
+}
+
+int Configuration::response_cache_time_bucket() const{
+    if (! vm.count("GENERAL.response_cache_time_bucket")) {
+        return 60;
+    }
+    return std::max(0, vm["GENERAL.response_cache_time_bucket"].as<int>());
+}
+
 std::vector<std::string> Configuration::rt_topics() const{
     if(! this->vm.count("BROKER.rt_topics")){
         return std::vector<std::string>();
@@ -180,6 +217,73 @@ bool Configuration::display_contributors() const{
     return vm["GENERAL.display_contributors"].as<bool>();
 }
 
+int Configuration::raptor_cache_warmup_days() const{
+    if (! vm.count("GENERAL.raptor_cache_warmup_days")) {
+        return 2;
+    }
+    return std::max(0, vm["GENERAL.raptor_cache_warmup_days"].as<int>());
+}
+
+std::vector<type::RTLevel> Configuration::raptor_cache_warmup_levels() const{
+    if (! vm.count("GENERAL.raptor_cache_warmup_levels")) {
+        return {type::RTLevel::Base, type::RTLevel::RealTime};
+    }
+    std::vector<type::RTLevel> levels;
+    for (const auto& level: vm["GENERAL.raptor_cache_warmup_levels"].as<std::vector<std::string>>()) {
+        levels.push_back(type::get_rt_level_from_string(level));
+    }
+    return levels;
+}
+
+bool Configuration::raptor_cache_warmup_wheelchair() const{
+    if (! vm.count("GENERAL.raptor_cache_warmup_wheelchair")) {
+        return true;
+    }
+    return vm["GENERAL.raptor_cache_warmup_wheelchair"].as<bool>();
+}
+
+size_t Configuration::nb_light_threads() const{
+    if (! vm.count("GENERAL.nb_light_threads")) {
+        return 1;
+    }
+    return size_t(std::max(0, vm["GENERAL.nb_light_threads"].as<int>()));
+}
+
+size_t Configuration::max_queue_size() const{
+    if (! vm.count("GENERAL.max_queue_size")) {
+        return 0;
+    }
+    return size_t(std::max(0, vm["GENERAL.max_queue_size"].as<int>()));
+}
+
+int Configuration::max_queue_age() const{
+    if (! vm.count("GENERAL.max_queue_age")) {
+        return 0;
+    }
+    return std::max(0, vm["GENERAL.max_queue_age"].as<int>());
+}
+
+int Configuration::request_timeout() const{
+    if (! vm.count("GENERAL.request_timeout")) {
+        return 0;
+    }
+    return std::max(0, vm["GENERAL.request_timeout"].as<int>());
+}
+
+int Configuration::journeys_timeout() const{
+    if (! vm.count("GENERAL.journeys_timeout")) {
+        return request_timeout();
+    }
+    return std::max(0, vm["GENERAL.journeys_timeout"].as<int>());
+}
+
+int Configuration::ptref_timeout() const{
+    if (! vm.count("GENERAL.ptref_timeout")) {
+        return request_timeout();
+    }
+    return std::max(0, vm["GENERAL.ptref_timeout"].as<int>());
+}
+
 size_t Configuration::raptor_cache_size() const{
     if (! vm.count("GENERAL.raptor_cache_size")) {
         return 10;
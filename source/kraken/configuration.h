@@ -31,6 +31,7 @@ www.navitia.io
 #pragma once
 #include <boost/program_options.hpp>
 #include <boost/optional.hpp>
+#include "type/rt_level.h"
 
 namespace navitia { namespace kraken{
 
@@ -46,6 +47,13 @@ namespace navitia { namespace kraken{
             std::string instance_name() const;
             boost::optional<std::string> chaos_database() const;
             int nb_threads() const;
+            size_t nb_light_threads() const;
+            size_t max_queue_size() const;
+            int max_queue_age() const;
+            // timeouts in ms, 0 if the requests are never aborted
+            int request_timeout() const;
+            int journeys_timeout() const;
+            int ptref_timeout() const;
 
             std::string broker_host() const;
             int broker_port() const;
@@ -60,6 +68,11 @@ namespace navitia { namespace kraken{
             int kirin_retry_timeout() const;
             bool display_contributors() const;
             size_t raptor_cache_size() const;
+            int raptor_cache_warmup_days() const;
+            std::vector<type::RTLevel> raptor_cache_warmup_levels() const;
+            bool raptor_cache_warmup_wheelchair() const;
+            size_t response_cache_size() const;
+            int response_cache_time_bucket() const;
 
             std::vector<std::string> rt_topics() const;
     };
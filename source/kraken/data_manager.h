@@ -38,6 +38,7 @@ www.navitia.io
 #endif
 
 #include <memory>
+#include <functional>
 #include <iostream>
 #include <atomic>
 #include <boost/make_shared.hpp>
@@ -78,6 +79,10 @@ public:
     void set_data(boost::shared_ptr<const Data>&& data) {
         if (!data) { throw navitia::exception("Giving a null Data to DataManager::set_data"); }
         data->is_connected_to_rabbitmq = current_data->is_connected_to_rabbitmq.load();
+        // the published data are immutable, their queries can be cached.
+        // The cache of the previous data dies with it.
+        data->enable_ptref_cache();
+        data->enable_route_schedule_cache();
         current_data = std::move(data);
     }
     boost::shared_ptr<const Data> get_data() const { return current_data; }
@@ -88,14 +93,17 @@ public:
         return std::move(data);
     }
 
+    // before_publish is called on the loaded data before they are published
     bool load(const std::string& database,
               const boost::optional<std::string>& chaos_database = boost::none,
-              const std::vector<std::string>& contributors = {}){
+              const std::vector<std::string>& contributors = {},
+              const std::function<void(const Data&)>& before_publish = {}){
         bool success;
         ++ data_identifier;
         auto data = create_data(data_identifier.load());
         success = data->load(database, chaos_database, contributors);
         if (success) {
+            if (before_publish) { before_publish(*data); }
             set_data(std::move(data));
         }
         return success;
@@ -36,14 +36,112 @@ www.navitia.io
 
 #include <boost/format.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <algorithm>
+#include <thread>
 
 
 namespace navitia {
 
 
 
+// the rows of a disruption, they can be spread over several chunks
+using DisruptionRows = std::vector<pqxx::result::const_iterator>;
+
+void DecodingPool::work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        job_ready.wait(lock, [&]() { return stopping || ! jobs.empty(); });
+        if (jobs.empty()) { return; }
+        auto job = std::move(jobs.front());
+        jobs.pop_front();
+        ++nb_running;
+        lock.unlock();
+
+        std::exception_ptr job_error;
+        try {
+            job();
+        } catch (...) {
+            job_error = std::current_exception();
+        }
+
+        lock.lock();
+        --nb_running;
+        if (job_error && ! error) { error = job_error; }
+        if (jobs.empty() && nb_running == 0) { jobs_done.notify_all(); }
+    }
+}
+
+DecodingPool::DecodingPool(size_t nb_threads) {
+    if (nb_threads <= 1) { return; }
+    for (size_t i = 0; i < nb_threads; ++i) {
+        threads.emplace_back([this]() { work(); });
+    }
+}
+
+DecodingPool::~DecodingPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    job_ready.notify_all();
+    for (auto& thread: threads) { thread.join(); }
+}
+
+void DecodingPool::run(std::vector<std::function<void()>> new_jobs) {
+    if (threads.empty()) {
+        std::exception_ptr first_error;
+        for (const auto& job: new_jobs) {
+            try {
+                job();
+            } catch (...) {
+                if (! first_error) { first_error = std::current_exception(); }
+            }
+        }
+        if (first_error) { std::rethrow_exception(first_error); }
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    for (auto& job: new_jobs) { jobs.push_back(std::move(job)); }
+    job_ready.notify_all();
+    jobs_done.wait(lock, [&]() { return jobs.empty() && nb_running == 0; });
+    if (error) {
+        auto e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+// decodes the disruptions on the pool, and applies them in order
+static void decode_and_apply(const std::vector<DisruptionRows>& disruptions_rows,
+                             DecodingPool& pool,
+                             type::PT_Data& pt_data,
+                             const type::MetaData& meta) {
+    std::vector<std::unique_ptr<chaos::Disruption>> disruptions(disruptions_rows.size());
+    std::vector<std::function<void()>> jobs;
+    jobs.reserve(disruptions_rows.size());
+    for (size_t i = 0; i < disruptions_rows.size(); ++i) {
+        jobs.push_back([&, i]() {
+            DisruptionDatabaseReader reader([&](std::unique_ptr<chaos::Disruption> d) {
+                disruptions[i] = std::move(d);
+            });
+            for (const auto& row: disruptions_rows[i]) {
+                reader(row);
+            }
+            reader.finalize();
+        });
+    }
+    pool.run(std::move(jobs));
+
+    for (const auto& disruption: disruptions) {
+        if (disruption) {
+            make_and_apply_disruption(*disruption, pt_data, meta);
+        }
+    }
+}
+
 void fill_disruption_from_database(const std::string& connection_string,
-        type::PT_Data& pt_data, type::MetaData &meta, const std::vector<std::string>& contributors) {
+        type::PT_Data& pt_data, type::MetaData &meta, const std::vector<std::string>& contributors,
+        size_t chunk_size, size_t nb_threads) {
     std::unique_ptr<pqxx::connection> conn;
     try{
         conn = std::unique_ptr<pqxx::connection>(new pqxx::connection(connection_string));
@@ -53,14 +151,13 @@ void fill_disruption_from_database(const std::string& connection_string,
     }
     pqxx::work work(*conn, "loading disruptions");
 
-    size_t offset = 0,
-           items_per_request = 100;
-    DisruptionDatabaseReader reader(pt_data, meta);
-    pqxx::result result;
+    if (nb_threads == 0) {
+        nb_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    DecodingPool pool(nb_threads);
     std::string contributors_array = boost::algorithm::join(contributors, ", ");
     LOG4CPLUS_INFO(log4cplus::Logger::getInstance("Logger"), "Reading disruptions from database");
-    do{
-        std::string request = (boost::format(
+    std::string request = (boost::format(
                "SELECT "
                // Disruptions field
                "     d.id as disruption_id, d.reference as disruption_reference, d.note as disruption_note,"
@@ -140,25 +237,34 @@ void fill_disruption_from_database(const std::string& connection_string,
                "     AND co.contributor_code = ANY('{%s}')" // it's like a "IN" but won't crash if empty"
                "     AND d.status = 'published'"
                "     AND i.status = 'published'"
+               // the disruptions not applied during the production period are useless
+               "     AND EXISTS (SELECT 1 FROM impact AS ai"
+               "         JOIN application_periods AS aa ON aa.impact_id = ai.id"
+               "         WHERE ai.disruption_id = d.id AND ai.status = 'published'"
+               "         AND aa.start_date < '%s'"
+               "         AND (aa.end_date IS NULL OR aa.end_date > '%s'))"
                "     ORDER BY d.id, c.id, t.id, i.id, a.id, p.id, m.id, ch.id, cht.id"
-               "     LIMIT %i OFFSET %i"
-               " ;") %meta.production_date.end() % meta.production_date.begin() %meta.production_date.end()  % contributors_array % items_per_request % offset).str();
-        result = work.exec(request);
-        for (auto res : result) {
-            reader(res);
-        }
+               " ;") %meta.production_date.end() % meta.production_date.begin() %meta.production_date.end()
+                     % contributors_array % meta.production_date.end() % meta.production_date.begin()).str();
+    LOG4CPLUS_TRACE(log4cplus::Logger::getInstance("sql"), request);
 
-        offset += result.size();
-        LOG4CPLUS_TRACE(log4cplus::Logger::getInstance("sql"), request);
-    }while(result.size() > 0);    
-    LOG4CPLUS_INFO(log4cplus::Logger::getInstance("Logger"),"Loading " << offset << " disruptions");
-    reader.finalize();
-    LOG4CPLUS_INFO(log4cplus::Logger::getInstance("Logger"),offset << " disruptions loaded");
+    // the query is run once, and its result is streamed by a server side
+    // cursor instead of paginated (each page would have run it again)
+    pqxx::icursorstream stream(work, request, "disruptions_cursor", chunk_size);
+    size_t nb_disruptions = 0;
+    const auto nb_rows = group_rows_by_disruption<pqxx::result>(
+        [&](pqxx::result& chunk) { return bool(stream >> chunk); },
+        [&](const std::vector<DisruptionRows>& disruptions_rows) {
+            nb_disruptions += disruptions_rows.size();
+            decode_and_apply(disruptions_rows, pool, pt_data, meta);
+        });
+    LOG4CPLUS_INFO(log4cplus::Logger::getInstance("Logger"),
+                   nb_disruptions << " disruptions loaded (" << nb_rows << " rows)");
 }
 
 void DisruptionDatabaseReader::finalize() {
     if (disruption && disruption->id() != "") {
-        make_and_apply_disruption(*disruption, pt_data, meta);
+        handler(std::move(disruption));
     }
 }
 
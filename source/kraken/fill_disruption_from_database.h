@@ -32,6 +32,13 @@ www.navitia.io
 #pragma once
 #include <string>
 #include <memory>
+#include <functional>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "type/pt_data.h"
 #include "pqxx/result.hxx"
 #include "type/chaos.pb.h"
@@ -54,11 +61,104 @@ namespace navitia {
         FILL_REQUIRED(table_name, created_at, uint64_t)\
         FILL_NULLABLE(table_name, updated_at, uint64_t)
 
+    /*
+     * The disruptions are read with a server side cursor, chunk_size rows at
+     * a time. The rows of each chunk are decoded by a pool of nb_threads
+     * threads (0 for one by core) started once for the whole load, then the
+     * disruptions are applied in order.
+     * The disruptions without any application period in the production
+     * period are filtered by the database.
+     */
     void fill_disruption_from_database(const std::string& connection_string,
-            navitia::type::PT_Data& pt_data, navitia::type::MetaData &meta, const std::vector<std::string>& contributors);
+            navitia::type::PT_Data& pt_data, navitia::type::MetaData &meta, const std::vector<std::string>& contributors,
+            size_t chunk_size = 1000, size_t nb_threads = 0);
+
+    /*
+     * Groups by disruption_id the rows of the chunks given by next_chunk
+     * (until it returns false or an empty chunk), the rows being sorted by
+     * disruption.
+     * After each chunk, on_disruptions is called with the rows of the
+     * disruptions entirely read (the last one may continue in the next
+     * chunk), then once at the end with the last disruption.
+     * A chunk is kept only while a disruption not yet given has rows in it.
+     * Returns the number of rows read.
+     */
+    template<typename Chunk, typename NextChunk, typename OnDisruptions>
+    size_t group_rows_by_disruption(NextChunk next_chunk, OnDisruptions on_disruptions) {
+        using Rows = std::vector<typename Chunk::const_iterator>;
+        // the chunks must live as long as their rows are used
+        std::deque<Chunk> chunks;
+        std::vector<Rows> disruptions_rows;
+        std::string last_id;
+        // numbers of the first chunk kept in memory and of the chunk where the last disruption begins
+        size_t first_chunk = 0, last_disruption_chunk = 0;
+        size_t nb_rows = 0;
+        Chunk chunk;
+        while (next_chunk(chunk)) {
+            if (chunk.empty()) { break; }
+            chunks.push_back(chunk);
+            for (auto it = chunks.back().begin(); it != chunks.back().end(); ++it) {
+                const auto id = it["disruption_id"].template as<std::string>();
+                if (disruptions_rows.empty() || last_id != id) {
+                    disruptions_rows.emplace_back();
+                    last_id = id;
+                    last_disruption_chunk = first_chunk + chunks.size() - 1;
+                }
+                disruptions_rows.back().push_back(it);
+            }
+            nb_rows += chunk.size();
+
+            // the last disruption may continue in the next chunk
+            auto last = std::move(disruptions_rows.back());
+            disruptions_rows.pop_back();
+            on_disruptions(disruptions_rows);
+            disruptions_rows.clear();
+            disruptions_rows.push_back(std::move(last));
+            // only the chunks of the last disruption are still needed
+            while (first_chunk < last_disruption_chunk) {
+                chunks.pop_front();
+                ++first_chunk;
+            }
+        }
+        on_disruptions(disruptions_rows);
+        return nb_rows;
+    }
+
+    /*
+     * Threads decoding the disruptions, started once for the whole load and
+     * fed with the disruptions of each chunk
+     */
+    class DecodingPool {
+        std::mutex mutex;
+        std::condition_variable job_ready; // or the pool is stopping
+        std::condition_variable jobs_done;
+        std::deque<std::function<void()>> jobs;
+        size_t nb_running = 0;
+        bool stopping = false;
+        std::exception_ptr error;
+        std::vector<std::thread> threads;
+
+        void work();
+
+    public:
+        // with 1 thread, the jobs are run by the caller
+        explicit DecodingPool(size_t nb_threads);
+        ~DecodingPool();
+
+        // runs the jobs, the first exception is thrown once they are all finished
+        void run(std::vector<std::function<void()>> new_jobs);
+    };
 
     struct DisruptionDatabaseReader {
-        DisruptionDatabaseReader(type::PT_Data& pt_data, const type::MetaData& meta) : pt_data(pt_data), meta(meta) {}
+        // called with each disruption once all its rows have been read
+        using DisruptionHandler = std::function<void(std::unique_ptr<chaos::Disruption>)>;
+
+        // the disruptions are applied on pt_data
+        DisruptionDatabaseReader(type::PT_Data& pt_data, const type::MetaData& meta) :
+            handler([&pt_data, &meta](std::unique_ptr<chaos::Disruption> d) {
+                make_and_apply_disruption(*d, pt_data, meta);
+            }) {}
+        explicit DisruptionDatabaseReader(DisruptionHandler handler) : handler(std::move(handler)) {}
 
         std::unique_ptr<chaos::Disruption> disruption = nullptr;
         chaos::Impact* impact = nullptr;
@@ -71,8 +171,7 @@ namespace navitia {
 
         std::set<std::string> message_ids;
         std::set<std::string> pt_object_ids;
-        type::PT_Data& pt_data;
-        const type::MetaData& meta;
+        DisruptionHandler handler;
 
         // This function and all others below are templated so they can be tested
         template<typename T>
@@ -128,7 +227,7 @@ namespace navitia {
         template<typename T>
         void fill_disruption(T const_it) {
             if (disruption) {
-                make_and_apply_disruption(*disruption, pt_data, meta);
+                handler(std::move(disruption));
             }
             disruption = std::make_unique<chaos::Disruption>();
             FILL_TIMESTAMPMIXIN(disruption)
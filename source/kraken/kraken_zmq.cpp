@@ -38,6 +38,7 @@ www.navitia.io
 #include <iostream>
 #include "utils/init.h"
 #include "kraken_zmq.h"
+#include "load_balancer.h"
 #include "utils/zmq.h"
 
 
@@ -75,9 +76,11 @@ int main(int argn, char** argv){
     // Catch startup exceptions; without this, startup errors are on stdout
     std::string zmq_socket = conf.zmq_socket_path();
     //TODO: try/catch
-    LoadBalancer lb(context);
+    namespace nk = navitia::kraken;
+    nk::PriorityLoadBalancer lb(context, conf.nb_light_threads(), conf.max_queue_size(),
+                                boost::posix_time::milliseconds(conf.max_queue_age()));
     try{
-        lb.bind(zmq_socket, "inproc://workers");
+        lb.bind(zmq_socket);
     }catch(zmq::error_t& e){
         LOG4CPLUS_ERROR(logger, "zmq::socket_t::bind() failure: " << e.what());
         return 1;
@@ -85,11 +88,20 @@ int main(int argn, char** argv){
 
     threads.create_thread(navitia::MaintenanceWorker(data_manager, conf));
 
+    // shared by all the workers
+    nk::ResponseCache response_cache(conf.response_cache_size(), conf.response_cache_time_bucket());
+
     int nb_threads = conf.nb_threads();
     // Launch pool of worker threads
     LOG4CPLUS_INFO(logger, "starting workers threads");
     for(int thread_nbr = 0; thread_nbr < nb_threads; ++thread_nbr) {
-        threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf));
+        threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf,
+                                        nk::get_workers_endpoint(nk::Lane::Heavy), std::ref(response_cache)));
+    }
+    // and the ones of the cheap requests
+    for(size_t thread_nbr = 0; thread_nbr < conf.nb_light_threads(); ++thread_nbr) {
+        threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf,
+                                        nk::get_workers_endpoint(nk::Lane::Light), std::ref(response_cache)));
     }
 
     // Connect worker threads to client threads via a queue
@@ -36,8 +36,10 @@ www.navitia.io
 #include <utils/zmq.h>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include "kraken/configuration.h"
+#include "kraken/response_cache.h"
 #include "type/meta_data.h"
 #include <log4cplus/ndc.h>
+#include <cstring>
 
 inline pbnavitia::Response make_internal_error(const std::exception& e) {
     pbnavitia::Response response;
@@ -51,11 +53,13 @@ inline pbnavitia::Response make_internal_error(const std::exception& e) {
 namespace pt = boost::posix_time;
 inline void doWork(zmq::context_t& context,
                    DataManager<navitia::type::Data>& data_manager,
-                   navitia::kraken::Configuration conf) {
+                   navitia::kraken::Configuration conf,
+                   const std::string& workers_endpoint,
+                   navitia::kraken::ResponseCache& response_cache) {
     auto logger = log4cplus::Logger::getInstance("worker");
 
     zmq::socket_t socket (context, ZMQ_REQ);
-    socket.connect("inproc://workers");
+    socket.connect(workers_endpoint.c_str());
     bool run = true;
     navitia::Worker w(data_manager, conf);
     z_send(socket, "READY");
@@ -78,6 +82,9 @@ inline void doWork(zmq::context_t& context,
         pbnavitia::Response result;
         pt::ptime start = pt::microsec_clock::universal_time();
         pbnavitia::API api = pbnavitia::UNKNOWN_API;
+        // serialized response, when it comes from the cache
+        std::shared_ptr<const std::string> cached_response;
+        boost::optional<navitia::kraken::ResponseKey> cache_key;
         if(!pb_req.ParseFromArray(request.data(), request.size())){
             LOG4CPLUS_WARN(logger, "receive invalid protobuf");
             result.mutable_error()->set_id(pbnavitia::Error::invalid_protobuf_request);
@@ -87,11 +94,26 @@ inline void doWork(zmq::context_t& context,
             if(api != pbnavitia::METADATAS){
                 LOG4CPLUS_DEBUG(logger, "receive request: " << pb_req.DebugString());
             }
+            const auto data_identifier = data_manager.get_data()->data_identifier;
+            cache_key = response_cache.make_key(pb_req, data_identifier);
+            if (cache_key) {
+                cached_response = response_cache.get(*cache_key);
+            }
             try {
-                result = w.dispatch(pb_req);
-                if(api != pbnavitia::METADATAS){
-                    LOG4CPLUS_TRACE(logger, "response: " << result.DebugString());
+                if (cached_response) {
+                    LOG4CPLUS_DEBUG(logger, "response found in cache");
+                } else {
+                    result = w.dispatch(pb_req);
+                    if(api != pbnavitia::METADATAS){
+                        LOG4CPLUS_TRACE(logger, "response: " << result.DebugString());
+                    }
                 }
+            } catch (const navitia::DeadlineExpired& e) {
+                // the request took too long, the client has already given up
+                LOG4CPLUS_WARN(logger, "request aborted: " << e.what());
+                result.Clear();
+                result.mutable_error()->set_id(pbnavitia::Error::service_unavailable);
+                result.mutable_error()->set_message(e.what());
             } catch (const navitia::recoverable_exception& e) {
                 //on a recoverable an internal server error is returned
                 LOG4CPLUS_ERROR(logger, "internal server error: " << e.what());
@@ -104,10 +126,23 @@ inline void doWork(zmq::context_t& context,
             } else {
                 result.set_publication_date(navitia::to_posix_timestamp(data_manager.get_data()->meta->publication_date));
             }
+            // the errors (loading, deadline...) are not cached, nor the
+            // responses computed while the data changed
+            if (result.has_error() || data_manager.get_data()->data_identifier != data_identifier) {
+                cache_key = boost::none;
+            }
         }
-        zmq::message_t reply(result.ByteSize());
+        zmq::message_t reply(cached_response ? cached_response->size() : result.ByteSize());
         try{
-            result.SerializeToArray(reply.data(), result.ByteSize());
+            if (cached_response) {
+                std::memcpy(reply.data(), cached_response->data(), cached_response->size());
+            } else {
+                result.SerializeToArray(reply.data(), result.ByteSize());
+                if (cache_key) {
+                    response_cache.insert(*cache_key, std::string(static_cast<const char*>(reply.data()),
+                                                                  reply.size()));
+                }
+            }
         }catch(const google::protobuf::FatalException& e){
             LOG4CPLUS_ERROR(logger, "failure during serialization: " << e.what());
             result = make_internal_error(e);
@@ -0,0 +1,211 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "kraken/load_balancer.h"
+#include "type/response.pb.h"
+#include "utils/zmq.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <log4cplus/loggingmacros.h>
+#include <algorithm>
+
+namespace pt = boost::posix_time;
+namespace gpi = google::protobuf::internal;
+
+namespace navitia { namespace kraken {
+
+Lane get_lane(pbnavitia::API api) {
+    switch (api) {
+    case pbnavitia::STATUS:
+    case pbnavitia::METADATAS:
+    case pbnavitia::places:
+    case pbnavitia::pt_objects:
+    case pbnavitia::place_uri:
+    case pbnavitia::place_code:
+        return Lane::Light;
+    default:
+        return Lane::Heavy;
+    }
+}
+
+std::string get_workers_endpoint(Lane lane) {
+    switch (lane) {
+    case Lane::Light: return "inproc://workers_light";
+    case Lane::Heavy: return "inproc://workers";
+    }
+    return "inproc://workers";
+}
+
+boost::optional<pbnavitia::API> read_requested_api(const std::string& request) {
+    google::protobuf::io::CodedInputStream input(
+        reinterpret_cast<const google::protobuf::uint8*>(request.data()), int(request.size()));
+    while (true) {
+        const auto tag = input.ReadTag();
+        if (tag == 0) { return boost::none; }
+        if (gpi::WireFormatLite::GetTagFieldNumber(tag) == pbnavitia::Request::kRequestedApiFieldNumber
+            && gpi::WireFormatLite::GetTagWireType(tag) == gpi::WireFormatLite::WIRETYPE_VARINT) {
+            google::protobuf::uint32 value;
+            if (! input.ReadVarint32(&value) || ! pbnavitia::API_IsValid(value)) { return boost::none; }
+            return pbnavitia::API(value);
+        }
+        if (! gpi::WireFormatLite::SkipField(&input, tag)) { return boost::none; }
+    }
+}
+
+bool RequestQueue::push(Request&& request) {
+    if (full()) { return false; }
+    requests.push_back(std::move(request));
+    return true;
+}
+
+boost::optional<RequestQueue::Request> RequestQueue::pop() {
+    if (requests.empty()) { return boost::none; }
+    auto res = std::move(requests.front());
+    requests.pop_front();
+    return std::move(res);
+}
+
+std::vector<RequestQueue::Request> RequestQueue::pop_expired(const pt::ptime& now) {
+    std::vector<Request> res;
+    if (! has_max_age()) { return res; }
+    // the requests are in reception order, the oldest first
+    while (! requests.empty() && now - requests.front().received > max_age) {
+        res.push_back(std::move(requests.front()));
+        requests.pop_front();
+    }
+    return res;
+}
+
+PriorityLoadBalancer::PriorityLoadBalancer(zmq::context_t& context,
+                                           size_t nb_light_workers,
+                                           size_t max_queue_size,
+                                           pt::time_duration max_queue_age):
+    clients(context, ZMQ_ROUTER),
+    light_lane_enabled(nb_light_workers > 0),
+    logger(log4cplus::Logger::getInstance("load_balancer")) {
+    for (auto& lane: lanes) {
+        lane = std::make_unique<LaneState>(context, max_queue_size, max_queue_age);
+    }
+}
+
+void PriorityLoadBalancer::bind(const std::string& clients_socket) {
+    clients.bind(clients_socket.c_str());
+    lane(Lane::Light).workers.bind(get_workers_endpoint(Lane::Light).c_str());
+    lane(Lane::Heavy).workers.bind(get_workers_endpoint(Lane::Heavy).c_str());
+}
+
+void PriorityLoadBalancer::reject(LaneState& lane_state,
+                                  const RequestQueue::Request& request,
+                                  const std::string& reason) {
+    ++lane_state.nb_rejected;
+    LOG4CPLUS_WARN(logger, "request rejected: " << reason
+                   << " (" << lane_state.nb_rejected << " rejected on this lane)");
+    pbnavitia::Response response;
+    response.mutable_error()->set_id(pbnavitia::Error::service_unavailable);
+    response.mutable_error()->set_message("kraken is overloaded: " + reason);
+    z_send(clients, request.client, ZMQ_SNDMORE);
+    z_send(clients, "", ZMQ_SNDMORE);
+    z_send(clients, response.SerializeAsString());
+}
+
+void PriorityLoadBalancer::receive_from_client() {
+    RequestQueue::Request request;
+    request.client = z_recv(clients);
+    z_recv(clients); // empty delimiter
+    request.body = z_recv(clients);
+    request.received = pt::microsec_clock::universal_time();
+
+    // an invalid request goes to the heavy lane, its worker will answer the error
+    const auto api = read_requested_api(request.body);
+    auto l = api ? get_lane(*api) : Lane::Heavy;
+    if (l == Lane::Light && ! light_lane_enabled) { l = Lane::Heavy; }
+    auto& lane_state = lane(l);
+    // when the queue is full, the request is not taken
+    if (lane_state.queue.full()) {
+        reject(lane_state, request, "too many waiting requests");
+    } else {
+        lane_state.queue.push(std::move(request));
+    }
+}
+
+void PriorityLoadBalancer::receive_from_worker(LaneState& lane_state) {
+    const auto worker = z_recv(lane_state.workers);
+    z_recv(lane_state.workers); // empty delimiter
+    const auto client = z_recv(lane_state.workers);
+    lane_state.available_workers.push_back(worker);
+    if (client == "READY") { return; }
+
+    z_recv(lane_state.workers); // empty delimiter
+    const auto reply = z_recv(lane_state.workers);
+    z_send(clients, client, ZMQ_SNDMORE);
+    z_send(clients, "", ZMQ_SNDMORE);
+    z_send(clients, reply);
+}
+
+void PriorityLoadBalancer::dispatch(LaneState& lane_state) {
+    for (const auto& request: lane_state.queue.pop_expired(pt::microsec_clock::universal_time())) {
+        reject(lane_state, request, "the request has waited too long");
+    }
+    while (! lane_state.available_workers.empty() && ! lane_state.queue.empty()) {
+        const auto request = lane_state.queue.pop();
+        z_send(lane_state.workers, lane_state.available_workers.front(), ZMQ_SNDMORE);
+        z_send(lane_state.workers, "", ZMQ_SNDMORE);
+        z_send(lane_state.workers, request->client, ZMQ_SNDMORE);
+        z_send(lane_state.workers, "", ZMQ_SNDMORE);
+        z_send(lane_state.workers, request->body);
+        lane_state.available_workers.pop_front();
+    }
+}
+
+void PriorityLoadBalancer::run() {
+    // the clients are always polled, the requests wait in our queues
+    // where they can be counted and aged
+    while (true) {
+        zmq::pollitem_t items[] = {
+            {static_cast<void*>(clients), 0, ZMQ_POLLIN, 0},
+            {static_cast<void*>(lane(Lane::Light).workers), 0, ZMQ_POLLIN, 0},
+            {static_cast<void*>(lane(Lane::Heavy).workers), 0, ZMQ_POLLIN, 0},
+        };
+        // wake up regularly to expire the waiting requests
+        const bool must_expire = std::any_of(lanes.begin(), lanes.end(), [](const std::unique_ptr<LaneState>& l) {
+            return l->queue.has_max_age() && ! l->queue.empty();
+        });
+        // 100ms, the unit of the timeout depends on the version of zmq
+        zmq::poll(items, 3, must_expire ? 100 * ZMQ_POLL_MSEC : -1);
+
+        if (items[1].revents & ZMQ_POLLIN) { receive_from_worker(lane(Lane::Light)); }
+        if (items[2].revents & ZMQ_POLLIN) { receive_from_worker(lane(Lane::Heavy)); }
+        if (items[0].revents & ZMQ_POLLIN) { receive_from_client(); }
+        for (auto& l: lanes) { dispatch(*l); }
+    }
+}
+
+}} // namespace navitia::kraken
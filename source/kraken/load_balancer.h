@@ -0,0 +1,135 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/request.pb.h"
+#include <zmq.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/optional.hpp>
+#include <log4cplus/logger.h>
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+
+namespace navitia { namespace kraken {
+
+/** The requests are dispatched in lanes, each one with its own pool of
+  * workers, so the slow requests (journeys, isochrones...) can't block
+  * the cheap ones (places, metadatas used as health check...).
+  */
+enum class Lane { Light = 0, Heavy = 1 };
+constexpr size_t nb_lanes = 2;
+
+Lane get_lane(pbnavitia::API api);
+
+/// endpoint the workers of a lane must connect to
+std::string get_workers_endpoint(Lane lane);
+
+/// Reads the requested_api of a serialized pbnavitia::Request without parsing all of it
+boost::optional<pbnavitia::API> read_requested_api(const std::string& request);
+
+/// The requests of a lane waiting for a worker
+class RequestQueue {
+public:
+    struct Request {
+        std::string client;
+        std::string body;
+        boost::posix_time::ptime received;
+    };
+
+    // 0 means no limit
+    RequestQueue(size_t max_size, boost::posix_time::time_duration max_age):
+        max_size(max_size), max_age(max_age) {}
+
+    /// false if the queue is full, the request must be rejected
+    bool push(Request&& request);
+    boost::optional<Request> pop();
+    /// removes and returns the requests that have been waiting for too long
+    std::vector<Request> pop_expired(const boost::posix_time::ptime& now);
+
+    size_t size() const { return requests.size(); }
+    bool empty() const { return requests.empty(); }
+    bool full() const { return max_size && requests.size() >= max_size; }
+    bool has_max_age() const { return ! max_age.is_special() && max_age.total_milliseconds() > 0; }
+
+private:
+    size_t max_size;
+    boost::posix_time::time_duration max_age;
+    std::deque<Request> requests;
+};
+
+/** Load balancer between the clients and the worker threads
+  *
+  * The requests are classified by lane (cf get_lane) and queued until a
+  * worker of their lane is available. A request is rejected with a
+  * service_unavailable error if the queue of its lane is full, or if it
+  * has waited longer than the max age.
+  *
+  * If a lane has no worker, its requests go to the heavy lane.
+  *
+  * The workers use a REQ socket, saying "READY" at startup, as for
+  * the classic LoadBalancer.
+  */
+class PriorityLoadBalancer {
+public:
+    PriorityLoadBalancer(zmq::context_t& context,
+                         size_t nb_light_workers,
+                         size_t max_queue_size,
+                         boost::posix_time::time_duration max_queue_age);
+
+    void bind(const std::string& clients_socket);
+    void run();
+
+private:
+    struct LaneState {
+        LaneState(zmq::context_t& context, size_t max_queue_size,
+                  boost::posix_time::time_duration max_queue_age):
+            workers(context, ZMQ_ROUTER), queue(max_queue_size, max_queue_age) {}
+        zmq::socket_t workers;
+        std::deque<std::string> available_workers;
+        RequestQueue queue;
+        size_t nb_rejected = 0;
+    };
+
+    zmq::socket_t clients;
+    std::array<std::unique_ptr<LaneState>, nb_lanes> lanes;
+    bool light_lane_enabled;
+    log4cplus::Logger logger;
+
+    LaneState& lane(Lane l) { return *lanes[size_t(l)]; }
+    void receive_from_client();
+    void receive_from_worker(LaneState&);
+    void reject(LaneState&, const RequestQueue::Request&, const std::string& reason);
+    void dispatch(LaneState&);
+};
+
+}} // namespace navitia::kraken
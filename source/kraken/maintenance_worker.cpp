@@ -35,11 +35,14 @@ www.navitia.io
 #include "realtime.h"
 #include "type/task.pb.h"
 #include "type/pt_data.h"
+#include "type/meta_data.h"
+#include "routing/dataraptor.h"
 #include <boost/algorithm/string/join.hpp>
 #include <boost/optional.hpp>
 #include <sys/stat.h>
 #include <signal.h>
 #include <SimpleAmqpClient/Envelope.h>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include "utils/get_hostname.h"
@@ -57,7 +60,8 @@ void MaintenanceWorker::load(){
     auto chaos_database = conf.chaos_database();
     auto contributors = conf.rt_topics();
     LOG4CPLUS_INFO(logger, "Loading database from file: " + database);
-    if(this->data_manager.load(database, chaos_database, contributors)){
+    auto warmup = [&](const nt::Data& data) { warmup_raptor_cache(data); };
+    if(this->data_manager.load(database, chaos_database, contributors, warmup)){
         auto data = data_manager.get_data();
         data->is_realtime_loaded = false;
         data->meta->instance_name = conf.instance_name();
@@ -66,6 +70,48 @@ void MaintenanceWorker::load(){
 }
 
 
+void MaintenanceWorker::warmup_raptor_cache(const nt::Data& data) const {
+    if (! data.dataRaptor->cached_next_st_manager) { return; }
+    const auto& production_date = data.meta->production_date;
+    const auto today = bg::day_clock::universal_day();
+    std::vector<nt::AccessibiliteParams> accessibilities(1);
+    if (conf.raptor_cache_warmup_wheelchair()) {
+        nt::AccessibiliteParams wheelchair;
+        wheelchair.properties.set(nt::hasProperties::WHEELCHAIR_BOARDING, true);
+        wheelchair.vehicle_properties.set(nt::hasVehicleProperties::WHEELCHAIR_ACCESSIBLE, true);
+        accessibilities.push_back(wheelchair);
+    }
+    std::vector<routing::CachedNextStopTimeKey> keys;
+    for (int i = 0; i < conf.raptor_cache_warmup_days(); ++i) {
+        const auto day = today + bg::days(i);
+        if (! production_date.contains(day)) { continue; }
+        const auto day_idx = size_t((day - production_date.begin()).days());
+        for (const auto level: conf.raptor_cache_warmup_levels()) {
+            for (const auto& accessibility: accessibilities) {
+                keys.emplace_back(day_idx, level, accessibility);
+            }
+        }
+    }
+    if (keys.empty()) { return; }
+    if (keys.size() > conf.raptor_cache_size()) {
+        // the extra caches would only evict the first ones, the keys of the nearest days are kept
+        LOG4CPLUS_WARN(logger, "more raptor caches to warm up (" << keys.size()
+                       << ") than raptor_cache_size, only " << conf.raptor_cache_size() << " are warmed up");
+        keys.erase(keys.begin() + conf.raptor_cache_size(), keys.end());
+    }
+
+    const auto start = pt::microsec_clock::universal_time();
+    try {
+        data.dataRaptor->cached_next_st_manager->warmup(keys);
+    } catch (const std::exception& e) {
+        // it is only an optimization, the caches will be built by the requests
+        LOG4CPLUS_WARN(logger, "raptor cache warmup failed: " << e.what());
+        return;
+    }
+    LOG4CPLUS_INFO(logger, keys.size() << " raptor caches warmed up in "
+                   << (pt::microsec_clock::universal_time() - start).total_milliseconds() << "ms");
+}
+
 void MaintenanceWorker::load_realtime(){
     if(!conf.is_realtime_enabled()){
         return;
@@ -156,42 +202,91 @@ void MaintenanceWorker::handle_task_in_batch(const std::vector<AmqpClient::Envel
 }
 
 
+// parses the feed messages of the envelopes in parallel, the invalid ones are skipped
+static std::vector<transit_realtime::FeedMessage>
+parse_feed_messages(const std::vector<AmqpClient::Envelope::ptr_t>& envelopes, log4cplus::Logger& logger) {
+    std::vector<transit_realtime::FeedMessage> messages(envelopes.size());
+    std::vector<char> is_valid(envelopes.size(), false);
+    const size_t nb_threads = std::min<size_t>(envelopes.size(),
+                                               std::max(1u, std::thread::hardware_concurrency()));
+    auto parse = [&](size_t first) {
+        for (size_t i = first; i < envelopes.size(); i += nb_threads) {
+            assert(envelopes[i]);
+            is_valid[i] = messages[i].ParseFromString(envelopes[i]->Message()->Body());
+        }
+    };
+    if (nb_threads <= 1) {
+        parse(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < nb_threads; ++i) {
+            threads.emplace_back(parse, i);
+        }
+        for (auto& thread: threads) {
+            thread.join();
+        }
+    }
+
+    std::vector<transit_realtime::FeedMessage> res;
+    res.reserve(messages.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        if (! is_valid[i]) {
+            LOG4CPLUS_WARN(logger, "protobuf not valid!");
+            continue;
+        }
+        LOG4CPLUS_TRACE(logger, "received entity: " << messages[i].DebugString());
+        res.push_back(std::move(messages[i]));
+    }
+    return res;
+}
+
 void MaintenanceWorker::handle_rt_in_batch(const std::vector<AmqpClient::Envelope::ptr_t>& envelopes){
+    if (envelopes.empty()) { return; }
+    LOG4CPLUS_DEBUG(logger, envelopes.size() << " realtime info received!");
+    const auto start = pt::microsec_clock::universal_time();
+    const auto messages = parse_feed_messages(envelopes, logger);
+    size_t nb_received = 0;
+    for (const auto& message: messages) {
+        nb_received += message.entity_size();
+    }
+    // the successive updates of a disruption (or trip) replace each other,
+    // only the last one is applied
+    const auto entities = coalesce_rt_entities(messages);
+    const auto end_parsing = pt::microsec_clock::universal_time();
+
     boost::shared_ptr<nt::Data> data{};
-    for (auto& envelope: envelopes) {
-        LOG4CPLUS_DEBUG(logger, "realtime info received!");
-        assert(envelope);
-        transit_realtime::FeedMessage feed_message;
-        if(! feed_message.ParseFromString(envelope->Message()->Body())){
-            LOG4CPLUS_WARN(logger, "protobuf not valid!");
-            return;
+    for (const auto& rt_entity: entities) {
+        const auto& entity = *rt_entity.entity;
+        if (!data) {
+            data = data_manager.get_data_clone();
+            data->last_rt_data_loaded = pt::microsec_clock::universal_time();
         }
-        LOG4CPLUS_TRACE(logger, "received entity: " << feed_message.DebugString());
-        for(const auto& entity: feed_message.entity()){
-            if (!data) {
-                data = data_manager.get_data_clone();
-                data->last_rt_data_loaded = pt::microsec_clock::universal_time();
-            }
-            if (entity.is_deleted()) {
-                LOG4CPLUS_DEBUG(logger, "deletion of disruption " << entity.id());
-                delete_disruption(entity.id(), *data->pt_data, *data->meta);
-            } else if(entity.HasExtension(chaos::disruption)) {
-                LOG4CPLUS_DEBUG(logger, "add/update of disruption " << entity.id());
-                make_and_apply_disruption(entity.GetExtension(chaos::disruption), *data->pt_data, *data->meta);
-            } else if(entity.has_trip_update()) {
-                LOG4CPLUS_DEBUG(logger, "RT trip update" << entity.id());
-                handle_realtime(entity.id(),
-                                navitia::from_posix_timestamp(feed_message.header().timestamp()),
-                                entity.trip_update(),
-                                *data);
-            } else {
-                LOG4CPLUS_WARN(logger, "unsupported gtfs rt feed");
-            }
+        if (entity.is_deleted()) {
+            LOG4CPLUS_DEBUG(logger, "deletion of disruption " << entity.id());
+            delete_disruption(entity.id(), *data->pt_data, *data->meta);
+        } else if(entity.HasExtension(chaos::disruption)) {
+            LOG4CPLUS_DEBUG(logger, "add/update of disruption " << entity.id());
+            make_and_apply_disruption(entity.GetExtension(chaos::disruption), *data->pt_data, *data->meta);
+        } else {
+            LOG4CPLUS_DEBUG(logger, "RT trip update" << entity.id());
+            handle_realtime(entity.id(),
+                            rt_entity.timestamp,
+                            entity.trip_update(),
+                            *data);
         }
     }
+    const auto end_applying = pt::microsec_clock::universal_time();
+    LOG4CPLUS_INFO(logger, "realtime batch: " << envelopes.size() << " messages ("
+                   << envelopes.size() - messages.size() << " invalid), "
+                   << nb_received << " entities received, "
+                   << nb_received - entities.size() << " coalesced or ignored, "
+                   << entities.size() << " applied, parsing: "
+                   << (end_parsing - start).total_milliseconds() << "ms, applying: "
+                   << (end_applying - end_parsing).total_milliseconds() << "ms");
     if (data) {
         LOG4CPLUS_INFO(logger, "rebuilding data raptor");
         data->build_raptor(conf.raptor_cache_size());
+        warmup_raptor_cache(*data);
         data_manager.set_data(std::move(data));
         LOG4CPLUS_INFO(logger, "data updated");
     }
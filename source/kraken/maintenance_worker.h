@@ -61,6 +61,10 @@ class MaintenanceWorker{
 
         void load_realtime();
 
+        // build the next stop time caches of the configured days and
+        // levels, to be called before publishing the data
+        void warmup_raptor_cache(const type::Data& data) const;
+
         /*!
          * This function will consume message in batch. It calls
          * AmqpClient::Channel::BasicConsumeMessage(const std::string&, Envelope::ptr_t&, int) to try
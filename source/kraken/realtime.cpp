@@ -35,11 +35,14 @@ www.navitia.io
 #include "type/datetime.h"
 #include "kraken/apply_disruption.h"
 #include "type/kirin.pb.h"
+#include "type/chaos.pb.h"
 
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
+#include <algorithm>
 #include <chrono>
+#include <unordered_map>
 
 namespace navitia {
 
@@ -315,4 +318,57 @@ void handle_realtime(const std::string& id,
     apply_disruption(*disruption, *data.pt_data, *data.meta);
 }
 
+/*
+ * An entity that would be ignored when applied must not replace an earlier
+ * entity of the same id, or the earlier update would be lost
+ */
+static bool can_be_applied(const transit_realtime::FeedEntity& entity) {
+    if (entity.is_deleted() || entity.HasExtension(chaos::disruption)) {
+        return true;
+    }
+    if (entity.has_trip_update()) {
+        return is_handleable(entity.trip_update()) && check_trip_update(entity.trip_update());
+    }
+    LOG4CPLUS_WARN(log4cplus::Logger::getInstance("realtime"), "unsupported gtfs rt feed");
+    return false;
+}
+
+std::vector<RtEntity> coalesce_rt_entities(const std::vector<transit_realtime::FeedMessage>& messages) {
+    // for each id, the position (message, entity) of its last entity
+    using Position = std::pair<size_t, int>;
+    std::unordered_map<std::string, Position> last_by_id;
+    auto get_timestamp = [&](const Position& pos) {
+        return messages[pos.first].header().timestamp();
+    };
+    for (size_t msg_idx = 0; msg_idx < messages.size(); ++msg_idx) {
+        for (int entity_idx = 0; entity_idx < messages[msg_idx].entity_size(); ++entity_idx) {
+            const Position pos{msg_idx, entity_idx};
+            const auto& entity = messages[msg_idx].entity(entity_idx);
+            if (! can_be_applied(entity)) { continue; }
+            const auto& id = entity.id();
+            auto it = last_by_id.find(id);
+            if (it == last_by_id.end()) {
+                last_by_id.emplace(id, pos);
+            } else if (get_timestamp(it->second) <= get_timestamp(pos)) {
+                // an older message arriving late does not override a newer one
+                it->second = pos;
+            }
+        }
+    }
+
+    std::vector<Position> kept;
+    kept.reserve(last_by_id.size());
+    for (const auto& id_pos: last_by_id) {
+        kept.push_back(id_pos.second);
+    }
+    std::sort(kept.begin(), kept.end());
+
+    std::vector<RtEntity> res;
+    res.reserve(kept.size());
+    for (const auto& pos: kept) {
+        res.push_back({&messages[pos.first].entity(pos.second), navitia::from_posix_timestamp(get_timestamp(pos))});
+    }
+    return res;
+}
+
 }
@@ -40,4 +40,23 @@ void handle_realtime(const std::string& id,
                      const transit_realtime::TripUpdate&,
                      const type::Data&);
 
+/// an entity of a realtime batch, with the timestamp of its feed message
+struct RtEntity {
+    const transit_realtime::FeedEntity* entity;
+    boost::posix_time::ptime timestamp;
+};
+
+/**
+ * Keeps only the last entity of each id in a batch of feed messages
+ *
+ * An entity (chaos disruption, trip update or deletion) replaces the whole
+ * disruption of its id, so only the last one, by timestamp of its feed
+ * then by order of arrival, has to be applied.
+ * The entities that would be ignored (unsupported, or trip updates that
+ * cannot be handled) are dropped first, so they do not hide an earlier
+ * valid update of their id.
+ * The kept entities are returned in their order of arrival.
+ */
+std::vector<RtEntity> coalesce_rt_entities(const std::vector<transit_realtime::FeedMessage>& messages);
+
 }
@@ -0,0 +1,75 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "response_cache.h"
+#include <boost/functional/hash.hpp>
+
+namespace navitia { namespace kraken {
+
+size_t hash_value(const ResponseKey& key) {
+    size_t seed = 0;
+    boost::hash_combine(seed, key.data_identifier);
+    boost::hash_combine(seed, key.request);
+    return seed;
+}
+
+boost::optional<ResponseKey> ResponseCache::make_key(const pbnavitia::Request& request,
+                                                     size_t data_identifier) const {
+    if (! enabled()) { return boost::none; }
+    switch (request.requested_api()) {
+    // they are cheap and must reflect the state of kraken
+    case pbnavitia::STATUS:
+    case pbnavitia::METADATAS:
+        return boost::none;
+    default:
+        break;
+    }
+
+    pbnavitia::Request canonical = request;
+    canonical.clear_request_id();
+    if (time_bucket > 0 && canonical.has__current_datetime()) {
+        const uint64_t now = canonical._current_datetime();
+        canonical.set__current_datetime(now - now % time_bucket);
+    }
+    return ResponseKey{data_identifier, canonical.SerializePartialAsString()};
+}
+
+std::shared_ptr<const std::string> ResponseCache::get(const ResponseKey& key) {
+    if (auto response = responses.get(key)) {
+        return *response;
+    }
+    return nullptr;
+}
+
+void ResponseCache::insert(const ResponseKey& key, std::string serialized_response) {
+    responses.insert(key, std::make_shared<const std::string>(std::move(serialized_response)));
+}
+
+}} // namespace navitia::kraken
@@ -0,0 +1,86 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/bounded_cache.h"
+#include "type/request.pb.h"
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+
+namespace navitia { namespace kraken {
+
+/// A request, as seen by the response cache
+struct ResponseKey {
+    size_t data_identifier;
+    std::string request; // serialized canonical request
+
+    bool operator==(const ResponseKey& other) const {
+        return data_identifier == other.data_identifier && request == other.request;
+    }
+};
+size_t hash_value(const ResponseKey& key);
+
+/** Serialized responses of the last requests, shared by all the workers
+  *
+  * The identical requests (same departure board, same ptref listing...)
+  * are answered without computing nor serializing anything.
+  *
+  * The request_id is not part of the key, and the current datetime is
+  * rounded to time_bucket seconds: a response can be served up to
+  * time_bucket seconds after it has been computed. The data_identifier
+  * is part of the key, so a new data (or realtime) never serves an old
+  * response.
+  */
+class ResponseCache {
+    BoundedCache<ResponseKey, std::shared_ptr<const std::string>> responses;
+    const size_t max_size;
+    const uint64_t time_bucket;
+
+public:
+    // a max_size of 0 disables the cache
+    ResponseCache(size_t max_size, uint64_t time_bucket):
+        responses(max_size), max_size(max_size), time_bucket(time_bucket) {}
+
+    bool enabled() const { return max_size > 0; }
+
+    /// the key of the request, none if its response must not be cached
+    boost::optional<ResponseKey> make_key(const pbnavitia::Request& request, size_t data_identifier) const;
+
+    std::shared_ptr<const std::string> get(const ResponseKey& key);
+    void insert(const ResponseKey& key, std::string serialized_response);
+
+    size_t size() const { return responses.size(); }
+    size_t get_nb_calls() const { return responses.get_nb_calls(); }
+    size_t get_nb_cache_miss() const { return responses.get_nb_cache_miss(); }
+};
+
+}} // namespace navitia::kraken
@@ -33,6 +33,7 @@ www.navitia.io
 #include <boost/test/unit_test.hpp>
 #include "tests/utils_test.h"
 #include "routing/raptor.h"
+#include "routing/dataraptor.h"
 #include "type/data.h"
 #include "ed/build_helper.h"
 #include "kraken/apply_disruption.h"
@@ -1161,3 +1162,102 @@ BOOST_AUTO_TEST_CASE(stop_point_deletion_test) {
     BOOST_CHECK_EQUAL(mvj_B->impacted_by.size(), 2);
 
 }
+
+BOOST_AUTO_TEST_CASE(impact_index_follows_the_disruptions) {
+    ed::builder b("20160101");
+    b.sa("S1")("S1");
+    b.sa("S2")("S2");
+    b.vj("A").uri("vj1")("S1", "08:00"_t)("S2", "09:00"_t);
+    b.finish();
+    b.data->pt_data->index();
+    b.data->build_raptor();
+    b.data->build_uri();
+
+    const auto& pt_data = *b.data->pt_data;
+    const auto& impact_index = pt_data.impact_index;
+    const auto& holder = pt_data.disruption_holder;
+    const auto* network = pt_data.networks_map.at("base_network");
+    const auto now = "20160101T120000"_dt;
+    const auto publication = btp("20160101T000000"_dt, "20160103T000000"_dt);
+    BOOST_CHECK(impact_index.can_answer(now, holder));
+
+    const auto& s2_closed = b.impact(nt::RTLevel::Adapted, "S2_closed")
+            .uri("S2_closed")
+            .severity(nt::disruption::Effect::NO_SERVICE)
+            .on(nt::Type_e::StopPoint, "S2")
+            .publish(publication)
+            .application_periods(publication)
+            .get_disruption();
+    // created but not applied yet
+    BOOST_CHECK(! impact_index.can_answer(now, holder));
+    navitia::apply_disruption(s2_closed, *b.data->pt_data, *b.data->meta);
+    BOOST_REQUIRE(impact_index.can_answer(now, holder));
+    BOOST_CHECK_EQUAL(impact_index.get_publishable_impacts(*network, now).size(), 1);
+    // applied again, it is not indexed twice
+    navitia::apply_disruption(s2_closed, *b.data->pt_data, *b.data->meta);
+    BOOST_REQUIRE(impact_index.can_answer(now, holder));
+    BOOST_CHECK_EQUAL(impact_index.get_publishable_impacts(*network, now).size(), 1);
+
+    // an impact never applied makes the index stale until it is built again
+    b.impact(nt::RTLevel::Adapted, "line_A_delayed")
+            .uri("line_A_delayed")
+            .severity(nt::disruption::Effect::SIGNIFICANT_DELAYS)
+            .on(nt::Type_e::Line, "A")
+            .publish(publication)
+            .application_periods(publication);
+    BOOST_CHECK(! impact_index.can_answer(now, holder));
+    b.data->build_raptor();
+    BOOST_REQUIRE(impact_index.can_answer(now, holder));
+    BOOST_CHECK_EQUAL(impact_index.get_publishable_impacts(*network, now).size(), 2);
+
+    navitia::delete_disruption("S2_closed", *b.data->pt_data, *b.data->meta);
+    BOOST_REQUIRE(impact_index.can_answer(now, holder));
+    const auto impacts = impact_index.get_publishable_impacts(*network, now);
+    BOOST_REQUIRE_EQUAL(impacts.size(), 1);
+    BOOST_CHECK_EQUAL(impacts[0]->uri, "line_A_delayed");
+    BOOST_CHECK_EQUAL(impact_index.get_publishable_impacts(*network, "20160102T120000"_dt).size(), 1);
+}
+
+/*
+ * The dataRaptor persisted by ed2nav is still used when the disruptions
+ * applied at load have created vjs and changed the validity patterns
+ */
+BOOST_AUTO_TEST_CASE(persisted_raptor_after_a_disruption) {
+    ed::builder b("20160101");
+    b.sa("S1")("S1");
+    b.sa("S2")("S2");
+    b.sa("S3")("S3");
+    b.vj("A").uri("vj1")("S1", "08:00"_t)("S2", "09:00"_t)("S3", "10:00"_t);
+    b.vj("A").uri("vj2")("S1", "10:00"_t)("S2", "10:30"_t)("S3", "11:00"_t);
+    b.finish();
+    b.data->pt_data->index();
+    b.data->build_raptor();
+    b.data->build_uri();
+    const auto persisted = b.data->dataRaptor->make_persisted(*b.data->pt_data);
+
+    navitia::apply_disruption(b.impact(nt::RTLevel::Adapted, "S2_closed")
+                              .severity(nt::disruption::Effect::NO_SERVICE)
+                              .on(nt::Type_e::StopPoint, "S2")
+                              .application_periods(btp("20160101T000000"_dt, "20160102T000000"_dt))
+                              .get_disruption(),
+                              *b.data->pt_data, *b.data->meta);
+    BOOST_REQUIRE_EQUAL(b.data->pt_data->vehicle_journeys.size(), 4);
+
+    navitia::routing::dataRAPTOR loaded;
+    BOOST_REQUIRE(loaded.load(*b.data->pt_data, persisted));
+    navitia::routing::dataRAPTOR computed;
+    computed.load(*b.data->pt_data);
+    BOOST_REQUIRE_EQUAL(loaded.jp_container.nb_jps(), computed.jp_container.nb_jps());
+    for (const auto& jp: computed.jp_container.get_jps()) {
+        BOOST_CHECK(loaded.jp_container.get(jp.first) == jp.second);
+    }
+    for (const auto level: {nt::RTLevel::Base, nt::RTLevel::Adapted, nt::RTLevel::RealTime}) {
+        BOOST_CHECK(loaded.jp_validity_patterns[level] == computed.jp_validity_patterns[level]);
+    }
+
+    // through build_raptor, as at load
+    b.data->persisted_raptor = std::make_unique<navitia::routing::PersistedRaptor>(persisted);
+    b.data->build_raptor();
+    BOOST_CHECK(! b.data->persisted_raptor);
+    BOOST_CHECK_EQUAL(b.data->dataRaptor->jp_container.nb_jps(), computed.jp_container.nb_jps());
+}
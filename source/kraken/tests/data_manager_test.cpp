@@ -45,6 +45,9 @@ class Data{
             return load_status;
         }
         mutable std::atomic<bool> is_connected_to_rabbitmq;
+        mutable bool ptref_cache_enabled = false;
+        void enable_ptref_cache() const { ptref_cache_enabled = true; }
+        void enable_route_schedule_cache() const {}
         static bool load_status;
         static bool destructor_called;
         size_t data_identifier;
@@ -81,6 +84,7 @@ BOOST_AUTO_TEST_CASE(load_success){
     BOOST_CHECK(data_manager.load(""));
     auto second_data = data_manager.get_data();
     BOOST_CHECK_NE(first_data, second_data);
+    BOOST_CHECK(second_data->ptref_cache_enabled);
     BOOST_CHECK_EQUAL(Data::destructor_called, false);
 }
 
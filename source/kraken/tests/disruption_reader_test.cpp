@@ -32,7 +32,10 @@ www.navitia.io
 #define BOOST_TEST_MODULE disruption_reader_test
 #include <boost/test/unit_test.hpp>
 #include "kraken/fill_disruption_from_database.h"
+#include <algorithm>
+#include <atomic>
 #include <map>
+#include <stdexcept>
 
 struct Const_it {
     struct Value {
@@ -599,3 +602,126 @@ BOOST_AUTO_TEST_CASE(two_ptobjects) {
     ptobject = impact.informed_entities(1);
     BOOST_CHECK_EQUAL(ptobject.uri(), "uri2");
 }
+
+BOOST_AUTO_TEST_CASE(disruption_handler) {
+    std::vector<std::string> ids;
+    navitia::DisruptionDatabaseReader reader([&](std::unique_ptr<chaos::Disruption> d) {
+        ids.push_back(d->id());
+    });
+
+    Const_it const_it;
+    const_it.set_cause("1", "wording", "11");
+    const_it.set_disruption("1", "22");
+    reader(const_it);
+    reader(const_it);
+    BOOST_CHECK(ids.empty());
+    const_it.set_disruption("2", "22");
+    reader(const_it);
+    BOOST_REQUIRE_EQUAL(ids.size(), 1);
+    BOOST_CHECK_EQUAL(ids[0], "1");
+    reader.finalize();
+    BOOST_REQUIRE_EQUAL(ids.size(), 2);
+    BOOST_CHECK_EQUAL(ids[0], "1");
+    BOOST_CHECK_EQUAL(ids[1], "2");
+    BOOST_CHECK(!reader.disruption);
+}
+
+// a chunk of rows, with only their disruption_id
+struct Chunk {
+    std::shared_ptr<std::vector<std::string>> ids = std::make_shared<std::vector<std::string>>();
+
+    struct const_iterator {
+        const Chunk* chunk;
+        size_t row;
+        Const_it::Value operator[] (const std::string&) const { return Const_it::Value((*chunk->ids)[row]); }
+        const_iterator& operator++() { ++row; return *this; }
+        bool operator!=(const const_iterator& other) const { return row != other.row; }
+    };
+
+    Chunk() {}
+    Chunk(std::vector<std::string> ids) : ids(std::make_shared<std::vector<std::string>>(std::move(ids))) {}
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size()}; }
+    size_t size() const { return ids->size(); }
+    bool empty() const { return ids->empty(); }
+};
+
+BOOST_AUTO_TEST_CASE(group_rows_by_disruption_across_chunks) {
+    // b spans 3 chunks, c spans 2 chunks
+    std::vector<Chunk> source = {{{"a", "b"}}, {{"b", "b"}}, {{"b", "c"}}, {{"c", "d"}}};
+    std::vector<std::weak_ptr<std::vector<std::string>>> watched;
+    for (const auto& chunk: source) { watched.push_back(chunk.ids); }
+    auto nb_released = [&]() {
+        return std::count_if(watched.begin(), watched.end(),
+                             [](const std::weak_ptr<std::vector<std::string>>& c) { return c.expired(); });
+    };
+
+    size_t next = 0;
+    std::vector<std::vector<std::pair<std::string, size_t>>> calls;
+    std::vector<long> released_at_call;
+    const auto nb_rows = navitia::group_rows_by_disruption<Chunk>(
+        [&](Chunk& chunk) {
+            if (next == source.size()) { return false; }
+            // the source must not keep the chunks alive
+            chunk = std::move(source[next++]);
+            return true;
+        },
+        [&](const std::vector<std::vector<Chunk::const_iterator>>& disruptions_rows) {
+            calls.emplace_back();
+            for (const auto& rows: disruptions_rows) {
+                BOOST_REQUIRE(! rows.empty());
+                for (const auto& row: rows) {
+                    BOOST_CHECK_EQUAL(row["disruption_id"].as<std::string>(),
+                                      rows.front()["disruption_id"].as<std::string>());
+                }
+                calls.back().emplace_back(rows.front()["disruption_id"].as<std::string>(), rows.size());
+            }
+            released_at_call.push_back(nb_released());
+        });
+
+    BOOST_CHECK_EQUAL(nb_rows, 8);
+    using Calls = std::vector<std::vector<std::pair<std::string, size_t>>>;
+    const Calls expected = {{{"a", 1}}, {}, {{"b", 4}}, {{"c", 2}}, {{"d", 1}}};
+    BOOST_REQUIRE_EQUAL(calls.size(), expected.size());
+    for (size_t i = 0; i < calls.size(); ++i) {
+        BOOST_CHECK(calls[i] == expected[i]);
+    }
+    // a chunk is released once all the disruptions having rows in it are given
+    const std::vector<long> expected_released = {0, 0, 0, 2, 3};
+    BOOST_CHECK_EQUAL_COLLECTIONS(released_at_call.begin(), released_at_call.end(),
+                                  expected_released.begin(), expected_released.end());
+}
+
+BOOST_AUTO_TEST_CASE(group_rows_by_disruption_without_rows) {
+    size_t nb_calls = 0;
+    const auto nb_rows = navitia::group_rows_by_disruption<Chunk>(
+        [](Chunk&) { return false; },
+        [&](const std::vector<std::vector<Chunk::const_iterator>>& disruptions_rows) {
+            BOOST_CHECK(disruptions_rows.empty());
+            ++nb_calls;
+        });
+    BOOST_CHECK_EQUAL(nb_rows, 0);
+    BOOST_CHECK_EQUAL(nb_calls, 1);
+}
+
+BOOST_AUTO_TEST_CASE(decoding_pool_job_throwing) {
+    for (size_t nb_threads: {1, 4}) {
+        navitia::DecodingPool pool(nb_threads);
+        std::atomic<int> nb_done(0);
+        std::vector<std::function<void()>> jobs;
+        for (int i = 0; i < 10; ++i) {
+            jobs.push_back([&nb_done, i]() {
+                if (i == 3) { throw std::runtime_error("bad disruption"); }
+                ++nb_done;
+            });
+        }
+        BOOST_CHECK_THROW(pool.run(std::move(jobs)), std::runtime_error);
+        // the other jobs are finished before the exception is thrown
+        BOOST_CHECK_EQUAL(nb_done.load(), 9);
+
+        // the pool can still be used after an error
+        nb_done = 0;
+        pool.run({[&nb_done]() { ++nb_done; }, [&nb_done]() { ++nb_done; }});
+        BOOST_CHECK_EQUAL(nb_done.load(), 2);
+    }
+}
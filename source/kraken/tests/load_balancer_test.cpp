@@ -0,0 +1,102 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_load_balancer
+#include <boost/test/unit_test.hpp>
+#include "kraken/load_balancer.h"
+#include "tests/utils_test.h"
+
+namespace nk = navitia::kraken;
+namespace pt = boost::posix_time;
+
+BOOST_AUTO_TEST_CASE(lanes) {
+    BOOST_CHECK(nk::get_lane(pbnavitia::METADATAS) == nk::Lane::Light);
+    BOOST_CHECK(nk::get_lane(pbnavitia::places) == nk::Lane::Light);
+    BOOST_CHECK(nk::get_lane(pbnavitia::pt_objects) == nk::Lane::Light);
+    BOOST_CHECK(nk::get_lane(pbnavitia::PLANNER) == nk::Lane::Heavy);
+    BOOST_CHECK(nk::get_lane(pbnavitia::ISOCHRONE) == nk::Lane::Heavy);
+    BOOST_CHECK(nk::get_lane(pbnavitia::PTREFERENTIAL) == nk::Lane::Heavy);
+    BOOST_CHECK_NE(nk::get_workers_endpoint(nk::Lane::Light), nk::get_workers_endpoint(nk::Lane::Heavy));
+}
+
+BOOST_AUTO_TEST_CASE(requested_api_without_parsing) {
+    pbnavitia::Request request;
+    request.set_requested_api(pbnavitia::places);
+    request.mutable_places()->set_q("bob");
+    std::string serialized;
+    request.SerializePartialToString(&serialized);
+    BOOST_CHECK_EQUAL(*nk::read_requested_api(serialized), pbnavitia::places);
+
+    // requested_api after another field
+    pbnavitia::Request places;
+    places.mutable_places()->set_q("bobette");
+    pbnavitia::Request api;
+    api.set_requested_api(pbnavitia::PLANNER);
+    serialized = places.SerializePartialAsString() + api.SerializePartialAsString();
+    BOOST_CHECK_EQUAL(*nk::read_requested_api(serialized), pbnavitia::PLANNER);
+
+    BOOST_CHECK(! nk::read_requested_api(places.SerializePartialAsString()));
+    BOOST_CHECK(! nk::read_requested_api("garbage"));
+    BOOST_CHECK(! nk::read_requested_api(""));
+}
+
+BOOST_AUTO_TEST_CASE(request_queue_max_size) {
+    nk::RequestQueue queue(2, pt::time_duration(pt::not_a_date_time));
+    const auto now = pt::microsec_clock::universal_time();
+    BOOST_CHECK(queue.push({"a", "", now}));
+    BOOST_CHECK(! queue.full());
+    BOOST_CHECK(queue.push({"b", "", now}));
+    BOOST_CHECK(queue.full());
+    BOOST_CHECK(! queue.push({"c", "", now}));
+    BOOST_CHECK_EQUAL(queue.size(), 2);
+    BOOST_CHECK(queue.pop_expired(now + pt::hours(1)).empty());
+    BOOST_CHECK_EQUAL(queue.pop()->client, "a");
+    BOOST_CHECK(! queue.full());
+    BOOST_CHECK(queue.push({"c", "", now}));
+    BOOST_CHECK_EQUAL(queue.pop()->client, "b");
+    BOOST_CHECK_EQUAL(queue.pop()->client, "c");
+    BOOST_CHECK(! queue.pop());
+}
+
+BOOST_AUTO_TEST_CASE(request_queue_max_age) {
+    nk::RequestQueue queue(0, pt::milliseconds(100));
+    const auto now = pt::microsec_clock::universal_time();
+    for (int i = 0; i < 5; ++i) {
+        BOOST_CHECK(queue.push({std::to_string(i), "", now + pt::milliseconds(i * 50)}));
+    }
+    BOOST_CHECK(queue.pop_expired(now + pt::milliseconds(100)).empty());
+    const auto expired = queue.pop_expired(now + pt::milliseconds(160));
+    BOOST_REQUIRE_EQUAL(expired.size(), 2);
+    BOOST_CHECK_EQUAL(expired[0].client, "0");
+    BOOST_CHECK_EQUAL(expired[1].client, "1");
+    BOOST_CHECK_EQUAL(queue.size(), 3);
+    BOOST_CHECK_EQUAL(queue.pop()->client, "2");
+}
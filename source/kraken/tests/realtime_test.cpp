@@ -35,6 +35,7 @@ www.navitia.io
 #include "type/pt_data.h"
 #include "type/kirin.pb.h"
 #include "kraken/realtime.h"
+#include "type/datetime.h"
 #include "ed/build_helper.h"
 #include "tests/utils_test.h"
 #include "routing/raptor.h"
@@ -1566,3 +1567,64 @@ BOOST_AUTO_TEST_CASE(unknown_stop_point) {
 
 }
 
+
+BOOST_AUTO_TEST_CASE(coalesce_rt_entities_test) {
+    auto make_message = [](uint64_t timestamp, const std::vector<std::pair<std::string, std::string>>& updates) {
+        transit_realtime::FeedMessage message;
+        message.mutable_header()->set_gtfs_realtime_version("1");
+        message.mutable_header()->set_timestamp(timestamp);
+        for (const auto& id_trip: updates) {
+            auto* entity = message.add_entity();
+            entity->set_id(id_trip.first);
+            *entity->mutable_trip_update() = make_cancellation_message(id_trip.second, "20150928");
+        }
+        return message;
+    };
+    std::vector<transit_realtime::FeedMessage> messages = {
+        make_message(100, {{"a", "vj:1"}, {"b", "vj:2"}}),
+        make_message(200, {{"a", "vj:1 again"}, {"c", "vj:3"}}),
+        // an older message arriving late does not override the newer ones
+        make_message(150, {{"a", "vj:1 late"}, {"b", "vj:2 again"}}),
+    };
+
+    const auto entities = navitia::coalesce_rt_entities(messages);
+
+    // only the last update of each id is kept, in the order of arrival
+    BOOST_REQUIRE_EQUAL(entities.size(), 3);
+    BOOST_CHECK_EQUAL(entities[0].entity->trip_update().trip().trip_id(), "vj:1 again");
+    BOOST_CHECK_EQUAL(entities[0].timestamp, navitia::from_posix_timestamp(200));
+    BOOST_CHECK_EQUAL(entities[1].entity->trip_update().trip().trip_id(), "vj:3");
+    BOOST_CHECK_EQUAL(entities[2].entity->trip_update().trip().trip_id(), "vj:2 again");
+    BOOST_CHECK_EQUAL(entities[2].timestamp, navitia::from_posix_timestamp(150));
+
+    BOOST_CHECK(navitia::coalesce_rt_entities({}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(coalesce_rt_entities_ignored_update_test) {
+    transit_realtime::FeedMessage first;
+    first.mutable_header()->set_gtfs_realtime_version("1");
+    first.mutable_header()->set_timestamp(100);
+    auto* cancellation = first.add_entity();
+    cancellation->set_id("a");
+    *cancellation->mutable_trip_update() = make_cancellation_message("vj:1", "20150928");
+
+    // a scheduled trip update without stop time cannot be handled
+    transit_realtime::FeedMessage second;
+    second.mutable_header()->set_gtfs_realtime_version("1");
+    second.mutable_header()->set_timestamp(200);
+    auto* unhandleable = second.add_entity();
+    unhandleable->set_id("a");
+    auto* trip = unhandleable->mutable_trip_update()->mutable_trip();
+    trip->set_trip_id("vj:1 ignored");
+    trip->set_start_date("20150928");
+    trip->set_schedule_relationship(transit_realtime::TripDescriptor_ScheduleRelationship_SCHEDULED);
+    auto* unsupported = second.add_entity();
+    unsupported->set_id("b");
+
+    const auto entities = navitia::coalesce_rt_entities({first, second});
+
+    // the ignored updates do not hide the earlier one
+    BOOST_REQUIRE_EQUAL(entities.size(), 1);
+    BOOST_CHECK_EQUAL(entities[0].entity->trip_update().trip().trip_id(), "vj:1");
+    BOOST_CHECK_EQUAL(entities[0].timestamp, navitia::from_posix_timestamp(100));
+}
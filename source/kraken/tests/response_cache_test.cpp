@@ -0,0 +1,88 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_response_cache
+#include <boost/test/unit_test.hpp>
+#include "kraken/response_cache.h"
+#include "tests/utils_test.h"
+
+namespace nk = navitia::kraken;
+
+static pbnavitia::Request make_request(const std::string& q, const std::string& request_id, uint64_t now) {
+    pbnavitia::Request request;
+    request.set_requested_api(pbnavitia::places);
+    request.mutable_places()->set_q(q);
+    request.set_request_id(request_id);
+    request.set__current_datetime(now);
+    return request;
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_keys) {
+    nk::ResponseCache cache(10, 60);
+    const auto key = cache.make_key(make_request("bob", "id1", 1200), 1);
+    BOOST_REQUIRE(key);
+
+    // the request_id is ignored, and the current datetime is rounded to the minute
+    BOOST_CHECK(*key == *cache.make_key(make_request("bob", "id2", 1200), 1));
+    BOOST_CHECK(*key == *cache.make_key(make_request("bob", "id3", 1259), 1));
+    BOOST_CHECK(! (*key == *cache.make_key(make_request("bob", "id1", 1260), 1)));
+    BOOST_CHECK(! (*key == *cache.make_key(make_request("bobette", "id1", 1200), 1)));
+    // a new data never serves the responses of the old one
+    BOOST_CHECK(! (*key == *cache.make_key(make_request("bob", "id1", 1200), 2)));
+
+    pbnavitia::Request status;
+    status.set_requested_api(pbnavitia::STATUS);
+    BOOST_CHECK(! cache.make_key(status, 1));
+
+    nk::ResponseCache disabled(0, 60);
+    BOOST_CHECK(! disabled.enabled());
+    BOOST_CHECK(! disabled.make_key(make_request("bob", "id1", 1200), 1));
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_get_insert) {
+    nk::ResponseCache cache(1, 60);
+    const auto bob = *cache.make_key(make_request("bob", "id1", 1200), 1);
+    const auto bobette = *cache.make_key(make_request("bobette", "id1", 1200), 1);
+
+    BOOST_CHECK(! cache.get(bob));
+    cache.insert(bob, "response of bob");
+    auto response = cache.get(bob);
+    BOOST_REQUIRE(response);
+    BOOST_CHECK_EQUAL(*response, "response of bob");
+
+    // the cache is bounded
+    cache.insert(bobette, "response of bobette");
+    BOOST_CHECK_EQUAL(cache.size(), 1);
+    BOOST_CHECK(! cache.get(bob));
+    BOOST_CHECK(cache.get(bobette));
+    BOOST_CHECK_EQUAL(cache.get_nb_calls(), 4);
+    BOOST_CHECK_EQUAL(cache.get_nb_cache_miss(), 2);
+}
@@ -212,12 +212,23 @@ void Worker::feed_publisher(pbnavitia::Response& response){
 void Worker::init_worker_data(const boost::shared_ptr<const navitia::type::Data> data){
     //@TODO should be done in data_manager
     if(data->data_identifier != this->last_data_identifier || !planner){
-        planner = std::make_unique<routing::RAPTOR>(*data);
-        street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref);
+        if (planner && street_network_worker) {
+            // the new data are often the same with some realtime, we
+            // keep the allocated state when it fits
+            const bool compatible = planner->is_compatible(*data);
+            planner = std::make_unique<routing::RAPTOR>(*data, std::move(*planner));
+            street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref,
+                                                                            std::move(*street_network_worker));
+            LOG4CPLUS_INFO(logger, "Rebind planner" << (compatible ? "" : " (resized)"));
+        } else {
+            planner = std::make_unique<routing::RAPTOR>(*data);
+            street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref);
+            LOG4CPLUS_INFO(logger, "Instanciate planner");
+        }
         this->last_data_identifier = data->data_identifier;
-
-        LOG4CPLUS_INFO(logger, "Instanciate planner");
     }
+    planner->deadline = deadline;
+    street_network_worker->set_deadline(deadline);
 }
 
 
@@ -671,10 +682,25 @@ pbnavitia::Response Worker::pt_ref(const pbnavitia::PTRefRequest &request,
                                     //not important for it to be in
                                     //the production period, it's used
                                     //to filter the disruptions
-                                    current_datetime);
+                                    current_datetime,
+                                    deadline);
 }
 
 
+static int get_timeout(const kraken::Configuration& conf, pbnavitia::API api) {
+    switch (api) {
+    case pbnavitia::ISOCHRONE:
+    case pbnavitia::NMPLANNER:
+    case pbnavitia::pt_planner:
+    case pbnavitia::PLANNER:
+        return conf.journeys_timeout();
+    case pbnavitia::PTREFERENTIAL:
+        return conf.ptref_timeout();
+    default:
+        return conf.request_timeout();
+    }
+}
+
 pbnavitia::Response Worker::dispatch(const pbnavitia::Request& request) {
     pbnavitia::Response response ;
     // These api can respond even if the data isn't loaded
@@ -691,6 +717,9 @@ pbnavitia::Response Worker::dispatch(const pbnavitia::Request& request) {
         return response;
     }
     boost::posix_time::ptime current_datetime = bt::from_time_t(request._current_datetime());
+    // nobody will read the answer once jormungandr has timed out, so we
+    // abort the computation instead of burning the cpu
+    deadline.set_in(bt::milliseconds(get_timeout(conf, request.requested_api())));
     switch(request.requested_api()){
         case pbnavitia::places: response = autocomplete(request.places(), current_datetime); break;
         case pbnavitia::pt_objects: response = pt_object(request.pt_objects(), current_datetime); break;
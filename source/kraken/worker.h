@@ -61,6 +61,8 @@ class Worker {
         log4cplus::Logger logger;
         size_t last_data_identifier = std::numeric_limits<size_t>::max();// to check that data did not change, do not use directly
         boost::posix_time::ptime last_load_at;
+        // deadline of the request being processed, set by dispatch
+        Deadline deadline;
 
     public:
         Worker(DataManager<navitia::type::Data>& data_manager, kraken::Configuration conf);
@@ -37,6 +37,13 @@ www.navitia.io
 #include <boost/iostreams/write.hpp>
 #include <boost/iostreams/read.hpp>
 #include <boost/cstdint.hpp>
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
 
 typedef std::exception LZ4Exception;
 
@@ -138,3 +145,314 @@ public:
     }
 };
 
+
+/**
+ * Helpers of the LZ4 frame format
+ * (cf https://github.com/lz4/lz4/blob/master/doc/lz4_Frame_format.md)
+ */
+namespace lz4_frame {
+
+struct Exception: public std::runtime_error {
+    Exception(const std::string& msg): std::runtime_error("lz4 frame: " + msg) {}
+};
+
+const uint32_t magic_number = 0x184D2204;
+const uint32_t uncompressed_flag = 0x80000000; // high bit of the size of a stored block
+const size_t block_size = 4 * 1024 * 1024; // 4MB, the biggest block size of the format
+const uint8_t block_size_id = 7; // id of the 4MB block size
+
+inline uint32_t read_le32(const char* src) {
+    const auto* s = reinterpret_cast<const unsigned char*>(src);
+    return uint32_t(s[0]) | (uint32_t(s[1]) << 8) | (uint32_t(s[2]) << 16) | (uint32_t(s[3]) << 24);
+}
+
+inline void write_le32(std::string& dest, uint32_t value) {
+    for (int i = 0; i < 4; ++i) { dest.push_back(char((value >> (8 * i)) & 0xFF)); }
+}
+
+inline uint32_t rotl32(uint32_t x, int r) { return (x << r) | (x >> (32 - r)); }
+
+/// xxHash32, the checksum used by the lz4 frame format
+inline uint32_t xxh32(const char* data, size_t len, uint32_t seed = 0) {
+    const uint32_t p1 = 2654435761U, p2 = 2246822519U, p3 = 3266489917U, p4 = 668265263U, p5 = 374761393U;
+    const char* p = data;
+    const char* const end = data + len;
+    uint32_t h32;
+    if (len >= 16) {
+        uint32_t v1 = seed + p1 + p2, v2 = seed + p2, v3 = seed, v4 = seed - p1;
+        auto round = [&](uint32_t acc, const char* input) {
+            return rotl32(acc + read_le32(input) * p2, 13) * p1;
+        };
+        for (; p + 16 <= end; p += 16) {
+            v1 = round(v1, p);
+            v2 = round(v2, p + 4);
+            v3 = round(v3, p + 8);
+            v4 = round(v4, p + 12);
+        }
+        h32 = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+    } else {
+        h32 = seed + p5;
+    }
+    h32 += uint32_t(len);
+    for (; p + 4 <= end; p += 4) {
+        h32 = rotl32(h32 + read_le32(p) * p3, 17) * p4;
+    }
+    for (; p < end; ++p) {
+        h32 = rotl32(h32 + uint32_t(static_cast<unsigned char>(*p)) * p5, 11) * p1;
+    }
+    h32 ^= h32 >> 15;
+    h32 *= p2;
+    h32 ^= h32 >> 13;
+    h32 *= p3;
+    h32 ^= h32 >> 16;
+    return h32;
+}
+
+/// compress one block, returns its size field, its data and its checksum
+inline std::string compress_block(const std::string& block) {
+    std::string compressed(LZ4_compressBound(block.size()), '\0');
+    const int compressed_size = LZ4_compress(block.data(), &compressed[0], block.size());
+    std::string res;
+    if (compressed_size > 0 && size_t(compressed_size) < block.size()) {
+        compressed.resize(compressed_size);
+        write_le32(res, compressed_size);
+    } else {
+        // incompressible, the block is stored as is
+        compressed = block;
+        write_le32(res, uint32_t(block.size()) | uncompressed_flag);
+    }
+    res += compressed;
+    write_le32(res, xxh32(compressed.data(), compressed.size()));
+    return res;
+}
+
+/// check and decompress one block (size field and checksum already removed)
+inline std::string decompress_block(const std::string& data, bool is_compressed,
+                                    bool has_checksum, uint32_t checksum) {
+    if (has_checksum && xxh32(data.data(), data.size()) != checksum) {
+        throw Exception("corrupted block, bad checksum");
+    }
+    if (! is_compressed) { return data; }
+    std::string res(block_size, '\0');
+    const int size = LZ4_uncompress_unknownOutputSize(data.data(), &res[0], data.size(), res.size());
+    if (size < 0) { throw Exception("corrupted block"); }
+    res.resize(size);
+    return res;
+}
+
+} // namespace lz4_frame
+
+/**
+ * Filtre de compression LZ4 au format "frame" pour boost::iostreams
+ *
+ * The data are cut in independent blocks of 4MB, each one with its
+ * checksum, so the file can be read by the lz4 command line tool.
+ * The blocks are compressed in parallel by nb_threads threads, and
+ * written in order.
+ */
+class LZ4FrameCompressor : public boost::iostreams::multichar_output_filter {
+    struct State {
+        size_t nb_threads;
+        bool header_written = false;
+        std::string block; // not yet compressed data
+        std::deque<std::future<std::string>> pending; // blocks being compressed, in order
+    };
+    std::shared_ptr<State> state; // the filter is copied by boost, the copies must share their state
+
+    template<typename Sink>
+    void write_string(Sink& dest, const std::string& str) {
+        boost::iostreams::write(dest, str.data(), str.size());
+    }
+
+    template<typename Sink>
+    void write_header(Sink& dest) {
+        std::string header;
+        lz4_frame::write_le32(header, lz4_frame::magic_number);
+        // version 01, independent blocks, block checksums
+        header.push_back(char(0x70));
+        header.push_back(char(lz4_frame::block_size_id << 4));
+        header.push_back(char((lz4_frame::xxh32(header.data() + 4, 2) >> 8) & 0xFF));
+        write_string(dest, header);
+        state->header_written = true;
+    }
+
+    template<typename Sink>
+    void flush_block(Sink& dest) {
+        if (state->block.empty()) { return; }
+        auto block = std::make_shared<std::string>(std::move(state->block));
+        state->block.clear();
+        state->pending.push_back(std::async(std::launch::async, [block]() {
+            return lz4_frame::compress_block(*block);
+        }));
+        // at most nb_threads blocks are compressed at the same time
+        while (state->pending.size() > state->nb_threads) {
+            write_string(dest, state->pending.front().get());
+            state->pending.pop_front();
+        }
+    }
+
+public:
+    LZ4FrameCompressor(size_t nb_threads = std::max(1u, std::thread::hardware_concurrency())):
+        state(std::make_shared<State>()) {
+        state->nb_threads = std::max(size_t(1), nb_threads);
+    }
+
+    template<typename Sink>
+    std::streamsize write(Sink& dest, const char* src, std::streamsize size) {
+        if (! state->header_written) { write_header(dest); }
+        std::streamsize written = 0;
+        while (written < size) {
+            const auto to_copy = std::min<std::streamsize>(size - written,
+                                                           lz4_frame::block_size - state->block.size());
+            state->block.append(src + written, to_copy);
+            written += to_copy;
+            if (state->block.size() == lz4_frame::block_size) { flush_block(dest); }
+        }
+        return written;
+    }
+
+    template<typename Sink>
+    void close(Sink& dest) {
+        if (! state->header_written) { write_header(dest); }
+        flush_block(dest);
+        for (auto& block: state->pending) { write_string(dest, block.get()); }
+        state->pending.clear();
+        std::string end_mark;
+        lz4_frame::write_le32(end_mark, 0);
+        write_string(dest, end_mark);
+        state->header_written = false;
+    }
+};
+
+/**
+ * Filtre de décompression LZ4 au format "frame" pour boost::iostreams
+ *
+ * The blocks are read in order and decompressed (and checked) in
+ * parallel by nb_threads threads. A truncated or corrupted stream throws
+ * a lz4_frame::Exception.
+ */
+class LZ4FrameDecompressor : public boost::iostreams::multichar_input_filter {
+    struct State {
+        size_t nb_threads;
+        bool header_read = false;
+        bool end_of_frame = false;
+        bool has_block_checksum = false;
+        bool has_content_checksum = false;
+        std::deque<std::future<std::string>> pending; // blocks being decompressed, in order
+        std::string current; // decompressed block being read
+        size_t pos = 0;
+    };
+    std::shared_ptr<State> state;
+
+    // return false if there is nothing to read at all
+    template<typename Source>
+    bool read_exactly(Source& src, char* dest, std::streamsize size, bool eof_allowed = false) {
+        std::streamsize done = 0;
+        while (done < size) {
+            const auto nb = boost::iostreams::read(src, dest + done, size - done);
+            if (nb < 0) {
+                if (done == 0 && eof_allowed) { return false; }
+                throw lz4_frame::Exception("truncated stream");
+            }
+            done += nb;
+        }
+        return true;
+    }
+
+    template<typename Source>
+    uint32_t read_le32(Source& src) {
+        char buf[4];
+        read_exactly(src, buf, 4);
+        return lz4_frame::read_le32(buf);
+    }
+
+    template<typename Source>
+    bool read_header(Source& src) {
+        char header[6];
+        if (! read_exactly(src, header, 6, true)) { return false; }
+        if (lz4_frame::read_le32(header) != lz4_frame::magic_number) {
+            throw lz4_frame::Exception("bad magic number");
+        }
+        const uint8_t flg = header[4];
+        if ((flg >> 6) != 1) { throw lz4_frame::Exception("unsupported version"); }
+        if (! (flg & 0x20)) { throw lz4_frame::Exception("linked blocks are not supported"); }
+        if (flg & 0x01) { throw lz4_frame::Exception("dictionaries are not supported"); }
+        state->has_block_checksum = flg & 0x10;
+        state->has_content_checksum = flg & 0x04;
+        std::string descriptor(header + 4, 2);
+        if (flg & 0x08) {
+            char content_size[8];
+            read_exactly(src, content_size, 8);
+            descriptor.append(content_size, 8);
+        }
+        char hc;
+        read_exactly(src, &hc, 1);
+        if (uint8_t(hc) != ((lz4_frame::xxh32(descriptor.data(), descriptor.size()) >> 8) & 0xFF)) {
+            throw lz4_frame::Exception("corrupted frame header");
+        }
+        state->header_read = true;
+        state->end_of_frame = false;
+        return true;
+    }
+
+    template<typename Source>
+    void schedule_next_block(Source& src) {
+        const uint32_t size_field = read_le32(src);
+        if (size_field == 0) {
+            // end mark, the content checksum is not checked
+            if (state->has_content_checksum) { read_le32(src); }
+            state->end_of_frame = true;
+            return;
+        }
+        const bool is_compressed = ! (size_field & lz4_frame::uncompressed_flag);
+        const uint32_t size = size_field & ~lz4_frame::uncompressed_flag;
+        if (size > lz4_frame::block_size) { throw lz4_frame::Exception("block too big"); }
+        auto data = std::make_shared<std::string>(size, '\0');
+        read_exactly(src, &(*data)[0], size);
+        const bool has_checksum = state->has_block_checksum;
+        const uint32_t checksum = has_checksum ? read_le32(src) : 0;
+        state->pending.push_back(std::async(std::launch::async, [=]() {
+            return lz4_frame::decompress_block(*data, is_compressed, has_checksum, checksum);
+        }));
+    }
+
+public:
+    LZ4FrameDecompressor(size_t nb_threads = std::max(1u, std::thread::hardware_concurrency())):
+        state(std::make_shared<State>()) {
+        state->nb_threads = std::max(size_t(1), nb_threads);
+    }
+
+    template<typename Source>
+    std::streamsize read(Source& src, char* dest, std::streamsize size) {
+        std::streamsize done = 0;
+        while (done < size) {
+            if (state->pos == state->current.size()) {
+                if (state->pending.empty() && (! state->header_read || state->end_of_frame)) {
+                    // begining of the stream or of a concatenated frame
+                    state->header_read = false;
+                    if (! read_header(src)) { break; }
+                }
+                while (! state->end_of_frame && state->pending.size() < state->nb_threads) {
+                    schedule_next_block(src);
+                }
+                if (state->pending.empty()) { continue; }
+                state->current = state->pending.front().get();
+                state->pending.pop_front();
+                state->pos = 0;
+                continue;
+            }
+            const auto to_copy = std::min<std::streamsize>(size - done, state->current.size() - state->pos);
+            std::copy_n(state->current.data() + state->pos, to_copy, dest + done);
+            state->pos += to_copy;
+            done += to_copy;
+        }
+        return done == 0 && size > 0 ? -1 : done;
+    }
+
+    template<typename Source>
+    void close(Source&) {
+        const auto nb_threads = state->nb_threads;
+        state = std::make_shared<State>();
+        state->nb_threads = nb_threads;
+    }
+};
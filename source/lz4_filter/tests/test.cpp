@@ -37,6 +37,8 @@ www.navitia.io
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/device/file.hpp>
 #include <string>
+#include <sstream>
+#include <iterator>
 
 
 BOOST_AUTO_TEST_CASE(tiny_string_compression){
@@ -98,3 +100,69 @@ BOOST_AUTO_TEST_CASE(big_string_compression){
     }
     BOOST_CHECK_EQUAL(str, result);
 }
+
+static std::string frame_compress(const std::string& str, size_t nb_threads) {
+    std::stringstream ss;
+    {
+        boost::iostreams::filtering_ostream out;
+        out.push(LZ4FrameCompressor(nb_threads));
+        out.push(ss);
+        out << str;
+    }
+    return ss.str();
+}
+
+static std::string frame_decompress(const std::string& compressed, size_t nb_threads) {
+    std::stringstream ss(compressed);
+    boost::iostreams::filtering_istream in;
+    in.push(LZ4FrameDecompressor(nb_threads));
+    in.push(ss);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+BOOST_AUTO_TEST_CASE(frame_string_compression) {
+    for (const std::string& str: {std::string(), std::string("foo")}) {
+        const auto compressed = frame_compress(str, 2);
+        // magic number of the lz4 frame format
+        BOOST_REQUIRE_GE(compressed.size(), 4);
+        BOOST_CHECK_EQUAL(lz4_frame::read_le32(compressed.data()), lz4_frame::magic_number);
+        BOOST_CHECK_EQUAL(frame_decompress(compressed, 2), str);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(frame_multi_blocks_compression) {
+    // more than 3 blocks, with incompressible parts, compressed and decompressed in parallel
+    std::string str;
+    unsigned int seed = 42;
+    while (str.size() < 3 * lz4_frame::block_size + 1000) {
+        str += "foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf";
+        seed = seed * 1103515245 + 12345;
+        str.push_back(char(seed >> 16));
+    }
+    for (size_t nb_threads: {1, 4}) {
+        const auto compressed = frame_compress(str, nb_threads);
+        BOOST_CHECK_LT(compressed.size(), str.size());
+        BOOST_CHECK(frame_decompress(compressed, nb_threads) == str);
+        BOOST_CHECK(frame_decompress(compressed, 3) == str);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(frame_corruptions) {
+    std::string str = "foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf";
+    for (int i = 0; i < 10; i++) {
+        str += str;
+    }
+    const auto compressed = frame_compress(str, 2);
+
+    // a truncated stream
+    BOOST_CHECK_THROW(frame_decompress(compressed.substr(0, compressed.size() - 10), 2), lz4_frame::Exception);
+    BOOST_CHECK_THROW(frame_decompress(compressed.substr(0, compressed.size() / 2), 2), lz4_frame::Exception);
+
+    // a modified byte in the first block (after the 7 bytes of header and the block size)
+    auto corrupted = compressed;
+    corrupted[20] ^= 0x01;
+    BOOST_CHECK_THROW(frame_decompress(corrupted, 2), lz4_frame::Exception);
+
+    // not a lz4 frame at all
+    BOOST_CHECK_THROW(frame_decompress("not compressed at all", 2), lz4_frame::Exception);
+}
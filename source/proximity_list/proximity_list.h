@@ -31,6 +31,7 @@ www.navitia.io
 #pragma once
 
 #include "type/type.h"
+#include "type/flat_array.h"
 #include <vector>
 #include <cmath>
 
@@ -67,11 +68,12 @@ struct ProximityList
     };
 
     /// Contient toutes les coordonnées de manière à trouver rapidement
-    std::vector<Item> items;
+    /// (used in place from the data file when it is memory mapped)
+    type::FlatArray<Item> items;
 
     /// Rajoute un nouvel élément. Attention, il faut appeler build avant de pouvoir utiliser la structure
     void add(GeographicalCoord coord, T element){
-        items.push_back(Item(coord,element));
+        items.edit().push_back(Item(coord,element));
     }
     void clear(){
         items.clear();
@@ -79,7 +81,8 @@ struct ProximityList
 
     /// Construit l'indexe
     void build(){
-        std::sort(items.begin(), items.end(), [](const Item & a, const Item & b){return a.coord < b.coord;});
+        auto& to_sort = items.edit();
+        std::sort(to_sort.begin(), to_sort.end(), [](const Item & a, const Item & b){return a.coord < b.coord;});
     }
 
     /// Retourne tous les éléments dans un rayon de x mètres
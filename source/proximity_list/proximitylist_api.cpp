@@ -171,4 +171,70 @@ pbnavitia::Response find(const type::GeographicalCoord& coord, const double dist
     pb_creator.make_paginate(total_result, start_page, count, result.size());
     return pb_creator.get_response();
 }
+
+static vector_idx_coord find_within(const nt::Type_e type, const type::GeographicalCoord& coord,
+                                    const double distance, const type::Data& data) {
+    switch(type){
+    case nt::Type_e::StopArea: return data.pt_data->stop_area_proximity_list.find_within(coord, distance);
+    case nt::Type_e::StopPoint: return data.pt_data->stop_point_proximity_list.find_within(coord, distance);
+    case nt::Type_e::POI: return data.geo_ref->poi_proximity_list.find_within(coord, distance);
+    default: return {};
+    }
+}
+
+std::vector<PlacesNearbyResult> find(const std::vector<type::GeographicalCoord>& coords, const double distance,
+                                     const std::vector<nt::Type_e>& types, const std::string& filter,
+                                     const uint32_t count, const uint32_t start_page, const type::Data& data) {
+    std::vector<PlacesNearbyResult> results(coords.size());
+    // the filter does not depend on the coordinate, we evaluate it only once for the batch
+    std::map<nt::Type_e, type::Indexes> filtered_indexes;
+    if (! filter.empty()) {
+        boost::optional<std::string> error;
+        try {
+            for (nt::Type_e type : types) {
+                if (type == nt::Type_e::Address || filtered_indexes.count(type)) { continue; }
+                filtered_indexes[type] = ptref::make_query(type, filter, data);
+            }
+        } catch(const ptref::parsing_error &parse_error) {
+            error = "Problem while parsing the query:" + parse_error.more;
+        } catch(const ptref::ptref_error &pt_error) {
+            error = "ptref : " + pt_error.more;
+        }
+        if (error) {
+            for (auto& result: results) { result.error = error; }
+            return results;
+        }
+    }
+
+    const size_t end_pagination = size_t(start_page + 1) * count;
+    for (size_t i = 0; i < coords.size(); ++i) {
+        const auto& coord = coords[i];
+        places_nearby result;
+        for (nt::Type_e type : types) {
+            if (type == nt::Type_e::Address) {
+                try {
+                    const auto nb_w = data.geo_ref->nearest_addr(coord);
+                    const auto addr_coord = nb_w.second->nearest_coord(nb_w.first, data.geo_ref->graph);
+                    result.push_back({nb_w.second->idx, type, coord.distance_to(addr_coord)});
+                } catch(proximitylist::NotFound) {}
+                continue;
+            }
+            const auto it_filter = filtered_indexes.find(type);
+            // the proximity list is usually way smaller than the filtered indexes,
+            // so we look up each found object in the indexes
+            for (const auto& idx_coord : find_within(type, coord, distance, data)) {
+                if (it_filter != filtered_indexes.end() && ! it_filter->second.count(idx_coord.first)) {
+                    continue;
+                }
+                result.push_back({idx_coord.first, type, coord.distance_to(idx_coord.second)});
+            }
+        }
+        const auto nb_sort = std::min(result.size(), end_pagination);
+        std::partial_sort(result.begin(), result.begin() + nb_sort, result.end(),
+                          [](const PlaceNearby& a, const PlaceNearby& b) { return a.distance < b.distance; });
+        result.resize(nb_sort);
+        results[i].places = paginate(result, count, start_page);
+    }
+    return results;
+}
 }} // namespace navitia::proximitylist
@@ -33,6 +33,7 @@ www.navitia.io
 #include "type/request.pb.h"
 #include "type/response.pb.h"
 #include "type/pt_data.h"
+#include <boost/optional.hpp>
 
 namespace navitia {
 
@@ -51,4 +52,30 @@ pbnavitia::Response find(const type::GeographicalCoord& coord, const double dist
                          const std::vector<type::Type_e>& types, const std::string& filter,
                          const uint32_t depth, const uint32_t count, const uint32_t start_page,
                          const type::Data& data, const boost::posix_time::ptime& current_datetime);
+
+/// compact description of an object found near a coordinate
+struct PlaceNearby {
+    type::idx_t idx;
+    type::Type_e type;
+    double distance;
+};
+typedef std::vector<PlaceNearby> places_nearby;
+
+/// result of a coordinate of a batch, with an invalid filter there is an error and no place
+struct PlacesNearbyResult {
+    places_nearby places;
+    boost::optional<std::string> error;
+};
+
+/**
+ * Batched version of find
+ *
+ * All the coordinates share the same parameters, thus the ptref filter is
+ * evaluated only once for the whole batch.
+ * The i-th element of the result is the page of the nearest objects of coords[i],
+ * sorted by distance.
+ */
+std::vector<PlacesNearbyResult> find(const std::vector<type::GeographicalCoord>& coords, const double distance,
+                                     const std::vector<type::Type_e>& types, const std::string& filter,
+                                     const uint32_t count, const uint32_t start_page, const type::Data& data);
 }} // namespace navitia::proximitylist
@@ -342,3 +342,66 @@ BOOST_AUTO_TEST_CASE(test_poi_filter) {
     BOOST_CHECK(poi_names.find("bob") != poi_names.end());
     BOOST_CHECK(poi_names.find("bobette") != poi_names.end());
 }
+
+BOOST_AUTO_TEST_CASE(test_batch) {
+    navitia::type::Data data;
+    auto sa = new navitia::type::StopArea();
+    sa->coord.set_lon(-1.554514);
+    sa->coord.set_lat(47.218515);
+    sa->idx = 0;
+    sa->name = "pouet";
+    data.pt_data->stop_areas.push_back(sa);
+    sa = new navitia::type::StopArea();
+    sa->coord.set_lon(-1.556949);
+    sa->coord.set_lat(47.217231);
+    sa->idx = 1;
+    sa->name = "paspouet";
+    data.pt_data->stop_areas.push_back(sa);
+    data.geo_ref->init();
+    data.build_proximity_list();
+
+    navitia::type::GeographicalCoord near_first(-1.554514, 47.218515);
+    navitia::type::GeographicalCoord near_second(-1.556949, 47.217231);
+    navitia::type::GeographicalCoord far_away(-1.554514, 50.218515);
+
+    auto results = find({near_first, near_second, far_away}, 100,
+                        {navitia::type::Type_e::StopArea}, "", 10, 0, data);
+    BOOST_REQUIRE_EQUAL(results.size(), 3);
+    BOOST_REQUIRE_EQUAL(results[0].places.size(), 1);
+    BOOST_CHECK_EQUAL(results[0].places[0].idx, 0);
+    BOOST_CHECK_EQUAL(results[0].places[0].type, navitia::type::Type_e::StopArea);
+    BOOST_CHECK_CLOSE(results[0].places[0].distance, 0, 1e-6);
+    BOOST_REQUIRE_EQUAL(results[1].places.size(), 1);
+    BOOST_CHECK_EQUAL(results[1].places[0].idx, 1);
+    BOOST_CHECK(results[2].places.empty());
+
+    // with a bigger distance, both are found, sorted by distance and cut to count
+    results = find({near_second}, 500, {navitia::type::Type_e::StopArea}, "", 1, 0, data);
+    BOOST_REQUIRE_EQUAL(results.size(), 1);
+    BOOST_REQUIRE_EQUAL(results[0].places.size(), 1);
+    BOOST_CHECK_EQUAL(results[0].places[0].idx, 1);
+
+    // the filter is applied to every coordinate of the batch
+    results = find({near_first, near_second}, 500, {navitia::type::Type_e::StopArea},
+                   "stop_area.name=pouet", 10, 0, data);
+    BOOST_REQUIRE_EQUAL(results.size(), 2);
+    BOOST_REQUIRE_EQUAL(results[0].places.size(), 1);
+    BOOST_CHECK_EQUAL(results[0].places[0].idx, 0);
+    BOOST_REQUIRE_EQUAL(results[1].places.size(), 1);
+    BOOST_CHECK_EQUAL(results[1].places[0].idx, 0);
+
+    // the second page
+    results = find({near_second}, 500, {navitia::type::Type_e::StopArea}, "", 1, 1, data);
+    BOOST_REQUIRE_EQUAL(results.size(), 1);
+    BOOST_REQUIRE_EQUAL(results[0].places.size(), 1);
+    BOOST_CHECK_EQUAL(results[0].places[0].idx, 0);
+
+    // a filter without any object is an error for each coordinate
+    results = find({near_first, near_second}, 500, {navitia::type::Type_e::StopArea},
+                   "stop_area.uri=unknown", 10, 0, data);
+    BOOST_REQUIRE_EQUAL(results.size(), 2);
+    for (const auto& result: results) {
+        BOOST_CHECK(result.error);
+        BOOST_CHECK(result.places.empty());
+    }
+}
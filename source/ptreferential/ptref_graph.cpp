@@ -31,6 +31,8 @@ www.navitia.io
 #include "ptref_graph.h"
 #include "ptreferential.h"
 #include <boost/graph/dijkstra_shortest_paths.hpp>
+#include <boost/optional.hpp>
+#include <mutex>
 
 namespace navitia { namespace ptref {
 
@@ -178,4 +180,27 @@ std::map<Type_e,Type_e> find_path(Type_e source) {
     return result;
 }
 
+const JoinPlan* get_join_plan(Type_e source, Type_e target) {
+    // the plans do not depend of the data, they are computed once and never invalidated
+    static std::mutex mutex;
+    static std::map<std::pair<Type_e, Type_e>, boost::optional<JoinPlan>> plans;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = plans.find({source, target});
+    if (it == plans.end()) {
+        // find_path gives the predecessors toward the target, we follow them from the source
+        auto path = find_path(target);
+        boost::optional<JoinPlan> plan = JoinPlan();
+        Type_e current = source;
+        while (path[current] != current) {
+            current = path[current];
+            plan->push_back(current);
+        }
+        if (current != target) { plan = boost::none; }
+        it = plans.insert({{source, target}, std::move(plan)}).first;
+    }
+    // the elements of a std::map are never moved, we can give a pointer on it
+    return it->second.get_ptr();
+}
+
 } } //namespace navitia::ptref
@@ -30,6 +30,7 @@ www.navitia.io
 
 #include "ptreferential.h"
 #include "reflexion.h"
+#include "query_cache.h"
 #include "where.h"
 #include "proximity_list/proximity_list.h"
 #include "type/data.h"
@@ -248,7 +249,7 @@ get_indexes_from_code(const Data&, const std::string&, const std::string&) {
 }
 
 template<typename T>
-Indexes get_indexes(Filter filter,  Type_e requested_type, const Data & d) {
+IndexesBitset get_indexes(Filter filter,  Type_e requested_type, const Data & d) {
     Indexes indexes;
     if(filter.op == DWITHIN) {
         std::vector<std::string> splited;
@@ -326,18 +327,17 @@ Indexes get_indexes(Filter filter,  Type_e requested_type, const Data & d) {
         indexes = filtered_indexes(data, build_clause<T>({filter}));
     }
     Type_e current = filter.navitia_type;
-    std::map<Type_e, Type_e> path = find_path(requested_type);
-    while(path[current] != current){
-        indexes = d.get_target_by_source(current, path[current], indexes);
-        current = path[current];
-    }
-
-    if (current != requested_type) {
+    const JoinPlan* plan = get_join_plan(current, requested_type);
+    if (! plan) {
         // there was no path to find a requested type
-        return Indexes{};
+        return IndexesBitset(d.get_nb_obj(requested_type));
     }
-
-    return indexes;
+    IndexesBitset bitset = to_bitset(indexes, d.get_nb_obj(current));
+    for (const Type_e next: *plan) {
+        bitset = get_target_by_source(current, next, bitset, d);
+        current = next;
+    }
+    return bitset;
 }
 
 std::vector<Filter> parse(std::string request){
@@ -356,18 +356,43 @@ std::vector<Filter> parse(std::string request){
     return filters;
 }
 
-Indexes get_difference(const Indexes& idxs1, const Indexes& idxs2) {
-    Indexes tmp_indexes;
-    std::insert_iterator<Indexes> it(tmp_indexes, std::begin(tmp_indexes));
-    std::set_difference(std::begin(idxs1), std::end(idxs1), std::begin(idxs2), std::end(idxs2), it);
-    return tmp_indexes;
+IndexesBitset to_bitset(const Indexes& indexes, size_t nb_obj) {
+    IndexesBitset bitset(nb_obj);
+    for (const idx_t idx: indexes) { bitset.set(idx); }
+    return bitset;
 }
 
-Indexes get_intersection(const Indexes& idxs1, const Indexes& idxs2) {
-   Indexes tmp_indexes;
-   std::insert_iterator<Indexes> it(tmp_indexes, std::begin(tmp_indexes));
-   std::set_intersection(std::begin(idxs1), std::end(idxs1), std::begin(idxs2), std::end(idxs2), it);
-   return tmp_indexes;
+Indexes to_indexes(const IndexesBitset& bitset) {
+    Indexes indexes;
+    indexes.reserve(bitset.count());
+    for (auto idx = bitset.find_first(); idx != bitset.npos; idx = bitset.find_next(idx)) {
+        // in order, so the insertion at the end is amortized constant
+        indexes.insert(indexes.end(), idx);
+    }
+    return indexes;
+}
+
+IndexesBitset get_target_by_source(Type_e source, Type_e target,
+                                   const IndexesBitset& source_idx, const type::Data& data) {
+    if (source == target) { return source_idx; }
+    IndexesBitset res(data.get_nb_obj(target));
+    const auto* relation = data.relation_index->get(source, target);
+    if (relation && relation->nb_sources() == source_idx.size() && relation->nb_targets() == res.size()) {
+        // the relation is materialized (and up to date: the vjs created by the
+        // disruptions since its build change the sizes), it's only an array walk
+        for (auto idx = source_idx.find_first(); idx != source_idx.npos; idx = source_idx.find_next(idx)) {
+            for (const idx_t target_idx: relation->get(idx)) {
+                res.set(target_idx);
+            }
+        }
+        return res;
+    }
+    for (auto idx = source_idx.find_first(); idx != source_idx.npos; idx = source_idx.find_next(idx)) {
+        for (const idx_t target_idx: data.get_target_by_one_source(source, target, idx)) {
+            res.set(target_idx);
+        }
+    }
+    return res;
 }
 
 Indexes manage_odt_level(const Indexes& final_indexes,
@@ -426,8 +451,16 @@ filter_vj_on_period(const Indexes& indexes,
                     const type::Data& data) {
 
     Indexes res;
+    const auto& vjs = data.pt_data->vehicle_journeys;
+    if (const auto running_vjs = data.temporal_index->get_vjs(period, vjs.size())) {
+        // the index gives directly the vehicle journeys of the period
+        for (const idx_t idx: indexes) {
+            if ((*running_vjs)[idx]) { res.insert(res.end(), idx); }
+        }
+        return res;
+    }
     for (const idx_t idx: indexes) {
-        const auto* vj = data.pt_data->vehicle_journeys[idx];
+        const auto* vj = vjs[idx];
         if (! keep_vj(vj, period)) { continue; }
         res.insert(idx);
     }
@@ -440,8 +473,18 @@ filter_impact_on_period(const Indexes& indexes,
                     const type::Data& data) {
 
     Indexes res;
+    const auto& weak_impacts = data.pt_data->disruption_holder.get_weak_impacts();
+    if (const auto applied_impacts = data.temporal_index->get_impacts(period, weak_impacts.size())) {
+        for (const idx_t idx: indexes) {
+            // the impact might have been deleted since the index was built
+            if ((*applied_impacts)[idx] && ! weak_impacts[idx].expired()) {
+                res.insert(res.end(), idx);
+            }
+        }
+        return res;
+    }
     for (const idx_t idx: indexes) {
-        auto impact = data.pt_data->disruption_holder.get_weak_impacts()[idx].lock();
+        auto impact = weak_impacts[idx].lock();
 
         if (! impact) { continue; }
 
@@ -500,19 +543,15 @@ filter_on_period(const Indexes& indexes,
     }
 }
 
-Indexes make_query(const Type_e requested_type,
-                              const std::string& request,
-                              const std::vector<std::string>& forbidden_uris,
-                              const type::OdtLevel_e odt_level,
-                              const boost::optional<boost::posix_time::ptime>& since,
-                              const boost::optional<boost::posix_time::ptime>& until,
-                              const Data& data) {
-    std::vector<Filter> filters;
-
-    if(!request.empty()){
-        filters = parse(request);
+// the filters do not depend of the data, the same strings come again and
+// again from jormungandr, so we keep the last parsed ones
+static std::vector<Filter> parse_and_type_filters(const std::string& request) {
+    static BoundedCache<std::string, std::vector<Filter>> cache(1000);
+    if (auto filters = cache.get(request)) {
+        return std::move(*filters);
     }
 
+    std::vector<Filter> filters = parse(request);
     type::static_data* static_data = type::static_data::get();
     for(Filter & filter : filters){
         try {
@@ -522,18 +561,38 @@ Indexes make_query(const Type_e requested_type,
                     "Filter Unknown object type: " + filter.object);
         }
     }
+    cache.insert(request, filters);
+    return filters;
+}
 
-    Indexes final_indexes;
-    if (! data.get_nb_obj(requested_type)) {
+static Indexes compute_query(const Type_e requested_type,
+                             const std::string& request,
+                             const std::vector<std::string>& forbidden_uris,
+                             const type::OdtLevel_e odt_level,
+                             const boost::optional<boost::posix_time::ptime>& since,
+                             const boost::optional<boost::posix_time::ptime>& until,
+                             const Data& data,
+                             const Deadline& deadline) {
+    std::vector<Filter> filters;
+
+    if(!request.empty()){
+        filters = parse_and_type_filters(request);
+    }
+    type::static_data* static_data = type::static_data::get();
+
+    const size_t nb_obj = data.get_nb_obj(requested_type);
+    if (! nb_obj) {
         throw ptref_error("Filters: No requested object in the database");
     }
 
+    IndexesBitset final_bitset(nb_obj);
     if (filters.empty()) {
-        final_indexes = data.get_all_index(requested_type);
+        final_bitset.set();
     } else {
-        Indexes indexes;
+        IndexesBitset indexes;
         bool first_time = true;
         for (const Filter& filter : filters) {
+            deadline.check("ptref filters");
             switch(filter.navitia_type){
     #define GET_INDEXES(type_name, collection_name)\
             case Type_e::type_name:\
@@ -568,15 +627,16 @@ Indexes make_query(const Type_e requested_type,
                         + nt::static_data::get()->captionByType(filter.navitia_type) + "<<");
             }
             if (first_time) {
-                final_indexes = indexes;
+                final_bitset = std::move(indexes);
             } else {
-                final_indexes = get_intersection(final_indexes, indexes);
+                final_bitset &= indexes;
             }
             first_time = false;
         }
     }
     //We now filter with forbidden uris
     for(const auto forbidden_uri : forbidden_uris) {
+        deadline.check("ptref forbidden uris");
         const auto type_ = data.get_type_of_id(forbidden_uri);
         //We don't use unknown forbidden type object as a filter.
         if (type_==navitia::type::Type_e::Unknown)
@@ -591,7 +651,7 @@ Indexes make_query(const Type_e requested_type,
 
         Filter filter_forbidden(caption_type, "uri", Operator_e::EQ, forbidden_uri);
         filter_forbidden.navitia_type = type_;
-        Indexes forbidden_idx;
+        IndexesBitset forbidden_idx;
         switch(type_){
 #define GET_INDEXES_FORBID(type_name, collection_name)\
         case Type_e::type_name:\
@@ -620,8 +680,9 @@ Indexes make_query(const Type_e requested_type,
                                 + nt::static_data::get()->captionByType(filter_forbidden.navitia_type)
                                 + "<<");
         }
-        final_indexes = get_difference(final_indexes, forbidden_idx);
+        final_bitset -= forbidden_idx;
     }
+    Indexes final_indexes = to_indexes(final_bitset);
     // Manage OdtLevel
     if (odt_level != navitia::type::OdtLevel_e::all) {
         final_indexes = manage_odt_level(final_indexes, requested_type, odt_level, data);
@@ -629,6 +690,7 @@ Indexes make_query(const Type_e requested_type,
 
     // filter on validity periods
     if (since || until) {
+        deadline.check("ptref period filter");
         final_indexes = filter_on_period(final_indexes, requested_type, since, until, data);
     }
 
@@ -662,6 +724,44 @@ Indexes make_query(const Type_e requested_type,
     return final_indexes;
 }
 
+std::shared_ptr<const Indexes> make_shared_query(const Type_e requested_type,
+                                                 const std::string& request,
+                                                 const std::vector<std::string>& forbidden_uris,
+                                                 const type::OdtLevel_e odt_level,
+                                                 const boost::optional<boost::posix_time::ptime>& since,
+                                                 const boost::optional<boost::posix_time::ptime>& until,
+                                                 const Data& data,
+                                                 const Deadline& deadline) {
+    if (! data.ptref_cache) {
+        return std::make_shared<const Indexes>(
+                    compute_query(requested_type, request, forbidden_uris, odt_level, since, until, data, deadline));
+    }
+    // only the successful queries are cached, the errors are thrown again each time
+    QueryKey key{requested_type, request, forbidden_uris, odt_level, since, until};
+    auto& results = data.ptref_cache->results;
+    if (auto indexes = results.get(key)) {
+        return *indexes;
+    }
+    auto indexes = std::make_shared<const Indexes>(
+                compute_query(requested_type, request, forbidden_uris, odt_level, since, until, data, deadline));
+    results.insert(std::move(key), indexes);
+    return indexes;
+}
+
+Indexes make_query(const Type_e requested_type,
+                   const std::string& request,
+                   const std::vector<std::string>& forbidden_uris,
+                   const type::OdtLevel_e odt_level,
+                   const boost::optional<boost::posix_time::ptime>& since,
+                   const boost::optional<boost::posix_time::ptime>& until,
+                   const Data& data,
+                   const Deadline& deadline) {
+    if (! data.ptref_cache) {
+        return compute_query(requested_type, request, forbidden_uris, odt_level, since, until, data, deadline);
+    }
+    return *make_shared_query(requested_type, request, forbidden_uris, odt_level, since, until, data, deadline);
+}
+
 Indexes make_query(const type::Type_e requested_type,
                                     const std::string& request,
                                     const std::vector<std::string>& forbidden_uris,
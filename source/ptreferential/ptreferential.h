@@ -52,6 +52,9 @@ www.navitia.io
 #include "georef/georef.h"
 #include "where.h"
 #include "utils/paginate.h"
+#include "type/deadline.h"
+#include <boost/dynamic_bitset.hpp>
+#include <memory>
 
 using navitia::type::Type_e;
 namespace navitia{ namespace ptref{
@@ -101,19 +104,32 @@ struct parsing_error : public ptref_error{
 };
 
 /// Exécute une requête sur les données Data : retourne les idx des objets demandés
+/// throws a DeadlineExpired if the evaluation goes beyond the deadline
 type::Indexes make_query(const type::Type_e requested_type,
                                     const std::string& request,
                                     const std::vector<std::string>& forbidden_uris,
                                     const type::OdtLevel_e odt_level,
                                     const boost::optional<boost::posix_time::ptime>& since,
                                     const boost::optional<boost::posix_time::ptime>& until,
-                                    const type::Data& data);
+                                    const type::Data& data,
+                                    const Deadline& deadline = Deadline());
 
 type::Indexes make_query(const type::Type_e requested_type,
                                     const std::string& request,
                                     const std::vector<std::string>& forbidden_uris,
                                     const type::Data& data);
 
+/// Same as make_query, but the indexes are shared with the ptref cache of the data:
+/// a query evaluated once can be paginated without being copied or evaluated again
+std::shared_ptr<const type::Indexes> make_shared_query(const type::Type_e requested_type,
+                                                       const std::string& request,
+                                                       const std::vector<std::string>& forbidden_uris,
+                                                       const type::OdtLevel_e odt_level,
+                                                       const boost::optional<boost::posix_time::ptime>& since,
+                                                       const boost::optional<boost::posix_time::ptime>& until,
+                                                       const type::Data& data,
+                                                       const Deadline& deadline = Deadline());
+
 type::Indexes make_query(const type::Type_e requested_type,
                                     const std::string& request,
                                     const type::Data& data);
@@ -123,14 +139,29 @@ type::Indexes make_query(const type::Type_e requested_type,
 /// Par exemple StopArea → StopPoint → JourneyPatternPoint
 std::map<Type_e,Type_e> find_path(Type_e source);
 
+/// Join plan compiled from find_path: the successive types to go through
+/// from source to target (source excluded, target included).
+/// Empty if source == target, null if there is no path.
+using JoinPlan = std::vector<Type_e>;
+const JoinPlan* get_join_plan(Type_e source, Type_e target);
+
 /// À parti d'un élément, on veut retrouver tous ceux de destination
 navitia::type::Indexes get(Type_e source, Type_e destination, type::idx_t source_idx, type::PT_Data & data);
 
 
 std::vector<Filter> parse(std::string request);
 
-type::Indexes get_difference(const type::Indexes&, const type::Indexes&);
-type::Indexes get_intersection(const type::Indexes&, const type::Indexes&);
+/// Inside ptref, the sets of objects are dense bitsets (one bit per object of the type)
+/// to have cheap bulk insertions and word-parallel intersections/differences.
+/// They are converted to ordered Indexes only at the end of the query
+using IndexesBitset = boost::dynamic_bitset<>;
+IndexesBitset to_bitset(const type::Indexes& indexes, size_t nb_obj);
+type::Indexes to_indexes(const IndexesBitset& bitset);
+
+/// bulk version of Data::get_target_by_source on bitsets
+/// (walks the relations of Data::relation_index when they are materialized)
+IndexesBitset get_target_by_source(Type_e source, Type_e target,
+                                   const IndexesBitset& source_idx, const type::Data& data);
 
 type::Indexes manage_odt_level(const type::Indexes& final_indexes,
                                           const navitia::type::Type_e requested_type,
@@ -134,12 +134,13 @@ pbnavitia::Response query_pb(const type::Type_e requested_type,
                              const boost::optional<boost::posix_time::ptime>& since,
                              const boost::optional<boost::posix_time::ptime>& until,
                              const type::Data& data,
-                             const boost::posix_time::ptime& current_datetime) {
-    type::Indexes final_indexes;
+                             const boost::posix_time::ptime& current_datetime,
+                             const Deadline& deadline) {
+    std::shared_ptr<const type::Indexes> indexes;
     pbnavitia::Response pb_response;
     int total_result;
     try {
-        final_indexes = make_query(requested_type, request, forbidden_uris, odt_level, since, until, data);
+        indexes = make_shared_query(requested_type, request, forbidden_uris, odt_level, since, until, data, deadline);
     } catch(const parsing_error &parse_error) {
         fill_pb_error(pbnavitia::Error::unable_to_parse, "Unable to parse :" + parse_error.more, pb_response.mutable_error());
         return pb_response;
@@ -147,9 +148,11 @@ pbnavitia::Response query_pb(const type::Type_e requested_type,
         fill_pb_error(pbnavitia::Error::bad_filter, "ptref : " + pt_error.more, pb_response.mutable_error());
         return pb_response;
     }
-    total_result = final_indexes.size();
-    final_indexes = paginate(final_indexes, count, startPage);
+    total_result = indexes->size();
+    // only the page is copied, the whole results stay in the ptref cache for the next pages
+    const auto final_indexes = paginate(*indexes, count, startPage);
 
+    deadline.check("ptref");
     pb_response = extract_data(data, requested_type, final_indexes, depth, current_datetime);
     auto pagination = pb_response.mutable_pagination();
     pagination->set_totalresult(total_result);
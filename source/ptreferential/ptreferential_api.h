@@ -29,6 +29,7 @@ www.navitia.io
 */
 
 #pragma once
+#include "type/deadline.h"
 
 namespace pbnavitia { class Response;}
 
@@ -45,5 +46,6 @@ pbnavitia::Response query_pb(const type::Type_e requested_type,
                              const boost::optional<boost::posix_time::ptime>& since,
                              const boost::optional<boost::posix_time::ptime>& until,
                              const type::Data& data,
-                             const boost::posix_time::ptime& current_datetime);
+                             const boost::posix_time::ptime& current_datetime,
+                             const Deadline& deadline = Deadline());
 }}
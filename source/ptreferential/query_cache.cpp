@@ -0,0 +1,55 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "query_cache.h"
+
+namespace navitia { namespace ptref {
+
+static void hash_date(size_t& seed, const boost::optional<boost::posix_time::ptime>& date) {
+    if (date && ! date->is_special()) {
+        boost::hash_combine(seed, (*date - boost::posix_time::ptime(boost::gregorian::date(1970, 1, 1)))
+                            .total_seconds());
+    } else {
+        boost::hash_combine(seed, bool(date));
+    }
+}
+
+size_t hash_value(const QueryKey& key) {
+    size_t seed = 0;
+    boost::hash_combine(seed, static_cast<int>(key.requested_type));
+    boost::hash_combine(seed, key.request);
+    boost::hash_combine(seed, key.forbidden_uris);
+    boost::hash_combine(seed, static_cast<int>(key.odt_level));
+    hash_date(seed, key.since);
+    hash_date(seed, key.until);
+    return seed;
+}
+
+}} //namespace navitia::ptref
@@ -0,0 +1,81 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/type_interfaces.h"
+#include "type/bounded_cache.h"
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+#include <memory>
+
+namespace navitia { namespace ptref {
+
+/// All the parameters of make_query
+struct QueryKey {
+    type::Type_e requested_type;
+    std::string request;
+    std::vector<std::string> forbidden_uris;
+    type::OdtLevel_e odt_level;
+    boost::optional<boost::posix_time::ptime> since;
+    boost::optional<boost::posix_time::ptime> until;
+
+    bool operator==(const QueryKey& other) const {
+        return requested_type == other.requested_type && request == other.request
+            && forbidden_uris == other.forbidden_uris && odt_level == other.odt_level
+            && since == other.since && until == other.until;
+    }
+};
+size_t hash_value(const QueryKey& key);
+
+/// The weight of a query result is its number of indexes (and 1 for the entry itself)
+struct IndexesWeight {
+    size_t operator()(const std::shared_ptr<const type::Indexes>& indexes) const { return indexes->size() + 1; }
+};
+
+/** Results of the ptref queries on a Data
+  *
+  * It is owned by the Data it caches: a new Data published by the
+  * DataManager comes with a new empty cache, the old one dies with the old Data.
+  *
+  * The results are shared: the successive pages of a query are cut in the
+  * same indexes, a page does not copy them nor computes the query again.
+  *
+  * The cache is bounded by the total number of indexes of its results, not
+  * by its number of results: a few extractions of all the vjs would weight
+  * a lot more than thousands of small queries.
+  */
+struct QueryCache {
+    BoundedCache<QueryKey, std::shared_ptr<const type::Indexes>, boost::hash<QueryKey>, IndexesWeight> results;
+    explicit QueryCache(size_t max_nb_indexes): results(max_nb_indexes) {}
+};
+
+}} //namespace navitia::ptref
@@ -44,7 +44,7 @@ www.navitia.io
 #include <boost/range/adaptors.hpp>
 
 namespace navitia{namespace ptref {
-template<typename T> nt::Indexes get_indexes(Filter filter,  Type_e requested_type, const type::Data & d);
+template<typename T> IndexesBitset get_indexes(Filter filter,  Type_e requested_type, const type::Data & d);
 }}
 
 namespace nt = navitia::type;
@@ -327,13 +327,13 @@ BOOST_AUTO_TEST_CASE(get_indexes_test){
     filter.attribute = "uri";
     filter.op = EQ;
     filter.value = "stop1";
-    auto indexes = get_indexes<nt::StopArea>(filter, Type_e::Line, *(b.data));
+    auto indexes = to_indexes(get_indexes<nt::StopArea>(filter, Type_e::Line, *(b.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, nt::make_indexes({0}));
 
     // On cherche les stopareas de la ligneA
     filter.navitia_type = Type_e::Line;
     filter.value = "A";
-    indexes = get_indexes<nt::Line>(filter, Type_e::StopArea, *(b.data));
+    indexes = to_indexes(get_indexes<nt::Line>(filter, Type_e::StopArea, *(b.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, nt::make_indexes({0, 1}));
 }
 
@@ -359,11 +359,11 @@ BOOST_AUTO_TEST_CASE(get_impact_indexes_of_line){
     filter.value = "A";
 
     navitia::apply_disruption(disrup_1, *b.data->pt_data, *b.data->meta);
-    auto indexes = get_indexes<nt::Line>(filter, Type_e::Impact, *(b.data));
+    auto indexes = to_indexes(get_indexes<nt::Line>(filter, Type_e::Impact, *(b.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, std::vector<size_t>{0});
 
     navitia::delete_disruption("Disruption 1", *b.data->pt_data, *b.data->meta);
-    indexes = get_indexes<nt::Line>(filter, Type_e::Impact, *(b.data));
+    indexes = to_indexes(get_indexes<nt::Line>(filter, Type_e::Impact, *(b.data)));
     BOOST_REQUIRE_EQUAL(indexes.size(), 0);
 
     const auto& disrup_2 = b.impact(nt::RTLevel::RealTime, "Disruption 2")
@@ -373,7 +373,7 @@ BOOST_AUTO_TEST_CASE(get_impact_indexes_of_line){
                      .get_disruption();
 
     navitia::apply_disruption(disrup_2, *b.data->pt_data, *b.data->meta);
-    indexes = get_indexes<nt::Line>(filter, Type_e::Impact, *(b.data));
+    indexes = to_indexes(get_indexes<nt::Line>(filter, Type_e::Impact, *(b.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, std::vector<size_t>{0});
 
     const auto& disrup_3 = b.impact(nt::RTLevel::RealTime, "Disruption 3")
@@ -383,7 +383,7 @@ BOOST_AUTO_TEST_CASE(get_impact_indexes_of_line){
                      .get_disruption();
 
     navitia::apply_disruption(disrup_3, *b.data->pt_data, *b.data->meta);
-    indexes = get_indexes<nt::Line>(filter, Type_e::Impact, *(b.data));
+    indexes = to_indexes(get_indexes<nt::Line>(filter, Type_e::Impact, *(b.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, nt::make_indexes({0, 1}));
 }
 
@@ -409,7 +409,7 @@ BOOST_AUTO_TEST_CASE(get_impact_indexes_of_stop_point){
     filter.value = "stop1";
 
     navitia::apply_disruption(disrup_1, *b.data->pt_data, *b.data->meta);
-    auto indexes = get_indexes<nt::StopPoint>(filter, Type_e::Impact, *(b.data));
+    auto indexes = to_indexes(get_indexes<nt::StopPoint>(filter, Type_e::Impact, *(b.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, std::vector<size_t>{0});
 }
 
@@ -609,7 +609,7 @@ BOOST_AUTO_TEST_CASE(mvj_filtering) {
     filter.attribute = "uri";
     filter.op = EQ;
     filter.value = "vehicle_journey 0";
-    indexes = get_indexes<nt::MetaVehicleJourney>(filter, Type_e::MetaVehicleJourney, *(builder.data));
+    indexes = to_indexes(get_indexes<nt::MetaVehicleJourney>(filter, Type_e::MetaVehicleJourney, *(builder.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, {0});
 
     // looking for MetaVJ A through VJ A
@@ -617,7 +617,7 @@ BOOST_AUTO_TEST_CASE(mvj_filtering) {
     filter.attribute = "uri";
     filter.op = EQ;
     filter.value = "vj:A:0";
-    indexes = get_indexes<nt::VehicleJourney>(filter, Type_e::MetaVehicleJourney, *(builder.data));
+    indexes = to_indexes(get_indexes<nt::VehicleJourney>(filter, Type_e::MetaVehicleJourney, *(builder.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, {0})
 
     //not limited, we get 3 vj
@@ -629,7 +629,7 @@ BOOST_AUTO_TEST_CASE(mvj_filtering) {
     filter.attribute = "uri";
     filter.op = EQ;
     filter.value = "vehicle_journey 1";
-    indexes = get_indexes<nt::MetaVehicleJourney>(filter, Type_e::VehicleJourney, *(builder.data));
+    indexes = to_indexes(get_indexes<nt::MetaVehicleJourney>(filter, Type_e::VehicleJourney, *(builder.data)));
     BOOST_CHECK_EQUAL_RANGE(indexes, {b})
 }
 
@@ -844,3 +844,178 @@ BOOST_AUTO_TEST_CASE(contributor_and_dataset) {
     BOOST_CHECK_THROW(make_query(nt::Type_e::Line, "contributor.uri=c2", *(b.data)),
                       ptref_error);
 }
+
+BOOST_AUTO_TEST_CASE(indexes_bitset) {
+    const auto indexes = nt::make_indexes({1, 4, 7});
+    const auto bitset = to_bitset(indexes, 10);
+    BOOST_CHECK_EQUAL(bitset.size(), 10);
+    BOOST_CHECK_EQUAL(bitset.count(), 3);
+    BOOST_CHECK_EQUAL_RANGE(to_indexes(bitset), indexes);
+    BOOST_CHECK(to_indexes(IndexesBitset(10)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(bulk_target_by_source) {
+    ed::builder b("201303011T1739");
+    b.generate_dummy_basis();
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8200, 8250);
+    b.vj("B")("stop2", 9000, 9050)("stop3", 9200, 9250);
+    b.finish();
+    b.data->pt_data->index();
+    b.data->pt_data->build_uri();
+    b.data->build_raptor();
+
+    // 4 journey pattern points for only 2 journey patterns, each one must appear only once
+    const auto all_jpps = b.data->get_all_index(Type_e::JourneyPatternPoint);
+    BOOST_CHECK_EQUAL(all_jpps.size(), 4);
+    const auto jps = b.data->get_target_by_source(Type_e::JourneyPatternPoint, Type_e::JourneyPattern, all_jpps);
+    BOOST_CHECK_EQUAL_RANGE(jps, b.data->get_all_index(Type_e::JourneyPattern));
+
+    const auto all_lines = b.data->get_all_index(Type_e::Line);
+    auto bitset = get_target_by_source(Type_e::Line, Type_e::Route,
+                                       to_bitset(all_lines, b.data->get_nb_obj(Type_e::Line)),
+                                       *b.data);
+    BOOST_CHECK_EQUAL(bitset.size(), b.data->get_nb_obj(Type_e::Route));
+    BOOST_CHECK_EQUAL_RANGE(to_indexes(bitset), b.data->get_all_index(Type_e::Route));
+}
+
+BOOST_AUTO_TEST_CASE(relation_index_and_join_plan) {
+    ed::builder b("201303011T1739");
+    b.generate_dummy_basis();
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8200, 8250);
+    b.vj("B")("stop2", 9000, 9050)("stop3", 9200, 9250);
+    b.finish();
+    b.data->pt_data->index();
+    b.data->pt_data->build_uri();
+    b.data->build_raptor();
+
+    // the relations are materialized by build_raptor and give the same results as the objects
+    BOOST_REQUIRE(b.data->relation_index->get(Type_e::Line, Type_e::Route));
+    BOOST_CHECK(! b.data->relation_index->get(Type_e::Impact, Type_e::Line));
+    for (const auto& pair: {std::make_pair(Type_e::StopPoint, Type_e::StopArea),
+                            std::make_pair(Type_e::StopPoint, Type_e::JourneyPatternPoint),
+                            std::make_pair(Type_e::Route, Type_e::VehicleJourney)}) {
+        const auto all = b.data->get_all_index(pair.first);
+        const auto bitset = get_target_by_source(pair.first, pair.second,
+                                                 to_bitset(all, b.data->get_nb_obj(pair.first)),
+                                                 *b.data);
+        BOOST_CHECK_EQUAL_RANGE(to_indexes(bitset),
+                                b.data->get_target_by_source(pair.first, pair.second, all));
+    }
+
+    // a vj added since the build (as by a disruption) is not in the relation, it is not used anymore
+    b.vj("A")("stop1", 10000, 10050)("stop2", 10200, 10250);
+    b.data->pt_data->index();
+    const auto routes = b.data->get_all_index(Type_e::Route);
+    const auto vjs = get_target_by_source(Type_e::Route, Type_e::VehicleJourney,
+                                          to_bitset(routes, b.data->get_nb_obj(Type_e::Route)), *b.data);
+    BOOST_CHECK_EQUAL(vjs.count(), 3);
+    BOOST_CHECK_EQUAL_RANGE(to_indexes(vjs), b.data->get_target_by_source(Type_e::Route, Type_e::VehicleJourney, routes));
+
+    // the plan to go from a line to its stop areas
+    const auto* plan = get_join_plan(Type_e::Line, Type_e::StopArea);
+    BOOST_REQUIRE(plan);
+    BOOST_REQUIRE(! plan->empty());
+    BOOST_CHECK(plan->front() == Type_e::Route);
+    BOOST_CHECK(plan->back() == Type_e::StopArea);
+    BOOST_CHECK(get_join_plan(Type_e::Line, Type_e::StopArea) == plan);
+    BOOST_REQUIRE(get_join_plan(Type_e::Route, Type_e::Route));
+    BOOST_CHECK(get_join_plan(Type_e::Route, Type_e::Route)->empty());
+
+    const auto stop_areas = make_query(Type_e::StopArea, "line.uri=A", *b.data);
+    BOOST_CHECK_EQUAL(stop_areas.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(ptref_query_cache) {
+    ed::builder b("201303011T1739");
+    b.generate_dummy_basis();
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8200, 8250);
+    b.vj("B")("stop2", 9000, 9050)("stop3", 9200, 9250);
+    b.finish();
+    b.data->pt_data->index();
+    b.data->pt_data->build_uri();
+    b.data->build_raptor();
+
+    // no cache as long as the data are not published
+    BOOST_CHECK(! b.data->ptref_cache);
+    const auto expected = make_query(Type_e::StopArea, "line.uri=A", *b.data);
+
+    // room for the 2 stop areas of the line A, and the entry itself
+    b.data->enable_ptref_cache(3);
+    const auto& results = b.data->ptref_cache->results;
+    BOOST_CHECK_EQUAL_RANGE(make_query(Type_e::StopArea, "line.uri=A", *b.data), expected);
+    BOOST_CHECK_EQUAL_RANGE(make_query(Type_e::StopArea, "line.uri=A", *b.data), expected);
+    BOOST_CHECK_EQUAL(results.get_nb_calls(), 2);
+    BOOST_CHECK_EQUAL(results.get_nb_cache_miss(), 1);
+
+    // the forbidden uris are part of the key
+    const auto without_stop1 = make_query(Type_e::StopArea, "line.uri=A", {"stop1"}, *b.data);
+    BOOST_CHECK_EQUAL(without_stop1.size(), expected.size() - 1);
+    BOOST_CHECK_EQUAL(results.get_nb_cache_miss(), 2);
+    // the cache is bounded by its number of indexes, the first query has been dropped
+    BOOST_CHECK_EQUAL(results.size(), 1);
+    BOOST_CHECK_EQUAL(results.get_weight(), 2);
+    BOOST_CHECK_EQUAL_RANGE(make_query(Type_e::StopArea, "line.uri=A", *b.data), expected);
+    BOOST_CHECK_EQUAL(results.get_nb_cache_miss(), 3);
+
+    // the pages of a query share the cached indexes
+    const auto indexes = make_shared_query(Type_e::StopArea, "line.uri=A", {}, nt::OdtLevel_e::all,
+                                           boost::none, boost::none, *b.data);
+    const auto next_page_indexes = make_shared_query(Type_e::StopArea, "line.uri=A", {}, nt::OdtLevel_e::all,
+                                                     boost::none, boost::none, *b.data);
+    BOOST_CHECK_EQUAL(indexes.get(), next_page_indexes.get());
+    BOOST_CHECK_EQUAL_RANGE(*indexes, expected);
+    BOOST_CHECK_EQUAL(results.get_nb_cache_miss(), 3);
+
+    // the errors are not cached
+    BOOST_CHECK_THROW(make_query(Type_e::StopArea, "line.uri=unknown", *b.data), ptref_error);
+    BOOST_CHECK_THROW(make_query(Type_e::StopArea, "line.uri=unknown", *b.data), ptref_error);
+
+    // a result bigger than the whole cache is not kept, nor does it evict the others
+    BOOST_CHECK_EQUAL(make_query(Type_e::StopPoint, "", *b.data).size(), 3);
+    BOOST_CHECK_EQUAL(results.size(), 1);
+    BOOST_CHECK_EQUAL_RANGE(make_query(Type_e::StopArea, "line.uri=A", *b.data), expected);
+    BOOST_CHECK_EQUAL(results.get_nb_cache_miss(), 6);
+}
+
+BOOST_AUTO_TEST_CASE(temporal_index_impacts) {
+    ed::builder b("20150928");
+    b.vj("A")("stop1", "08:00"_t)("stop2", "09:00"_t);
+    b.generate_dummy_basis();
+    b.finish();
+    b.data->pt_data->index();
+    b.data->pt_data->build_uri();
+
+    using btp = boost::posix_time::time_period;
+    // impact 0 on the 28th, impact 1 on the 29th and impact 2 on both, in 2 application periods
+    b.impact(nt::RTLevel::RealTime).severity(nt::disruption::Effect::NO_SERVICE).on(nt::Type_e::Line, "A")
+            .application_periods(btp("20150928T000000"_dt, "20150928T240000"_dt));
+    b.impact(nt::RTLevel::RealTime).severity(nt::disruption::Effect::NO_SERVICE).on(nt::Type_e::Line, "A")
+            .application_periods(btp("20150929T000000"_dt, "20150929T240000"_dt));
+    b.impact(nt::RTLevel::RealTime).severity(nt::disruption::Effect::NO_SERVICE).on(nt::Type_e::Line, "A")
+            .application_periods(btp("20150928T100000"_dt, "20150928T110000"_dt))
+            .application_periods(btp("20150929T230000"_dt, "20150930T010000"_dt));
+
+    const auto& index = *b.data->temporal_index;
+    // the index has been built before the impacts, it can't be used
+    BOOST_CHECK(! index.get_impacts(btp("20150928T000000"_dt, "20150929T000000"_dt), 3));
+
+    b.data->build_temporal_index();
+    auto get_impacts = [&](const btp& period) {
+        const auto bitset = index.get_impacts(period, 3);
+        BOOST_REQUIRE(bitset);
+        return to_indexes(*bitset);
+    };
+    BOOST_CHECK_EQUAL_RANGE(get_impacts(btp("20150928T000000"_dt, "20150929T000000"_dt)),
+                            nt::make_indexes({0, 2}));
+    BOOST_CHECK_EQUAL_RANGE(get_impacts(btp("20150928T120000"_dt, "20150929T000000"_dt)),
+                            nt::make_indexes({0}));
+    BOOST_CHECK_EQUAL_RANGE(get_impacts(btp("20150929T120000"_dt, "20150929T130000"_dt)),
+                            nt::make_indexes({1}));
+    BOOST_CHECK_EQUAL_RANGE(get_impacts(btp("20150930T000000"_dt, "20150930T020000"_dt)),
+                            nt::make_indexes({2}));
+    BOOST_CHECK(get_impacts(btp("20151001T000000"_dt, "20151002T000000"_dt)).empty());
+
+    // and the ptref query gives the same result
+    const auto indexes = query(nt::Type_e::Impact, "", *b.data, {"20150930T000000"_dt}, {"20150930T020000"_dt});
+    BOOST_CHECK_EQUAL_RANGE(indexes, nt::make_indexes({2}));
+}
@@ -31,8 +31,13 @@ www.navitia.io
 #include "dataraptor.h"
 #include "routing.h"
 #include "routing/raptor_utils.h"
+#include "routing/get_stop_times.h"
 
 #include <boost/range/algorithm_ext.hpp>
+#include <boost/range/algorithm/sort.hpp>
+#include <boost/functional/hash.hpp>
+#include <map>
+#include <set>
 
 namespace navitia { namespace routing {
 
@@ -69,6 +74,62 @@ void dataRAPTOR::JppsFromSp::filter_jpps(const boost::dynamic_bitset<>& valid_jp
     }
 }
 
+void dataRAPTOR::RoutePoints::load(const JourneyPatternContainer& jp_container) {
+    route_points.clear();
+    route_point_of_jpp.assign(jp_container.get_jpps_values());
+    std::map<std::pair<SpIdx, RouteIdx>, size_t> idx_by_key;
+    for (const auto& jp: jp_container.get_jps()) {
+        for (const auto& jpp_idx: jp.second.jpps) {
+            const auto& jpp = jp_container.get(jpp_idx);
+            const auto key = std::make_pair(jpp.sp_idx, jp.second.route_idx);
+            const auto it = idx_by_key.insert({key, route_points.size()}).first;
+            if (it->second == route_points.size()) {
+                route_points.push_back({jpp.sp_idx, jp.second.route_idx, {}});
+            }
+            route_points[it->second].jpps.push_back(jpp_idx);
+            route_point_of_jpp[jpp_idx] = it->second;
+        }
+    }
+    route_points.shrink_to_fit();
+}
+
+const std::vector<dataRAPTOR::CalendarStopTimes::TimeSt>*
+dataRAPTOR::CalendarStopTimes::get(const JppIdx& jpp, const std::string& calendar_id) const {
+    const auto cal_it = stop_times.find(calendar_id);
+    if (cal_it == stop_times.end()) { return nullptr; }
+    const auto it = cal_it->second.find(jpp);
+    if (it == cal_it->second.end()) { return nullptr; }
+    return &it->second;
+}
+
+void dataRAPTOR::CalendarStopTimes::load(const JourneyPatternContainer& jp_container) {
+    stop_times.clear();
+    for (const auto& jp: jp_container.get_jps()) {
+        std::set<const type::MetaVehicleJourney*> meta_vjs;
+        for (const auto* vj: jp.second.discrete_vjs) { meta_vjs.insert(vj->meta_vj); }
+        for (const auto* vj: jp.second.freq_vjs) { meta_vjs.insert(vj->meta_vj); }
+        for (const auto* meta_vj: meta_vjs) {
+            if (meta_vj->associated_calendars.empty()) { continue; }
+            //we can get only the first theoric one, because BY CONSTRUCTION all theoric vj have the same local times
+            const auto& vj = *meta_vj->get_base_vj().front();
+            for (const auto& cal: meta_vj->associated_calendars) {
+                auto& jpps_stop_times = stop_times[cal.first];
+                for (const auto& jpp_idx: jp.second.jpps) {
+                    add_stop_times_in_day(vj, jp_container.get(jpp_idx), jpps_stop_times[jpp_idx]);
+                }
+            }
+        }
+    }
+    for (auto& jpps_stop_times: stop_times) {
+        for (auto& jpp_stop_times: jpps_stop_times.second) {
+            boost::sort(jpp_stop_times.second, [](const TimeSt& a, const TimeSt& b) {
+                return DateTimeUtils::hour(a.first) < DateTimeUtils::hour(b.first);
+            });
+            jpp_stop_times.second.shrink_to_fit();
+        }
+    }
+}
+
 void dataRAPTOR::JppsFromJp::load(const JourneyPatternContainer& jp_container) {
     jpps_from_jp.assign(jp_container.get_jps_values());
     for (const auto& jp: jp_container.get_jps()) {
@@ -82,34 +143,118 @@ void dataRAPTOR::JppsFromJp::load(const JourneyPatternContainer& jp_container) {
 }
 
 
+static const auto rt_levels = {type::RTLevel::Base, type::RTLevel::Adapted, type::RTLevel::RealTime};
+
+// a hash of the base validity patterns of the nb_vjs first vjs, to detect
+// that they have changed since the PersistedRaptor was computed.  The
+// disruptions only change the adapted and realtime validity patterns.
+static size_t vp_fingerprint(const type::PT_Data& data, size_t nb_vjs) {
+    size_t seed = 0;
+    std::hash<type::ValidityPattern::year_bitset> hasher;
+    for (size_t vj_idx = 0; vj_idx < nb_vjs; ++vj_idx) {
+        const auto* vp = data.vehicle_journeys[vj_idx]->validity_patterns[type::RTLevel::Base];
+        if (vp == nullptr) {
+            boost::hash_combine(seed, 0);
+            continue;
+        }
+        boost::hash_combine(seed, hasher(vp->days));
+    }
+    return seed;
+}
+
 void dataRAPTOR::load(const type::PT_Data& data, size_t cache_size)
 {
     jp_container.load(data);
+    load_jp_validity_patterns();
+    load_from_jps(data, cache_size);
+}
+
+bool dataRAPTOR::load(const type::PT_Data& data,
+                      const PersistedRaptor& persisted,
+                      size_t cache_size) {
+    if (persisted.version != PersistedRaptor::current_version
+        || persisted.nb_vjs > data.vehicle_journeys.size()
+        || persisted.jp_validity_patterns.size() != 1
+        || persisted.vp_fingerprint != vp_fingerprint(data, persisted.nb_vjs)) {
+        return false;
+    }
+    const auto& days = persisted.jp_validity_patterns.front();
+    if (days.size() != 366) { return false; }
+    for (const auto& blocks: days) {
+        if (blocks.size() * boost::dynamic_bitset<>::bits_per_block < persisted.jp_vjs.size()) { return false; }
+    }
+    // the persisted jps come first, then the ones of the vjs added since
+    if (! jp_container.load(data, persisted.jp_vjs)) { return false; }
+
+    // only the base level is persisted, the disruptions applied at load change the others
+    auto& jp_vp = jp_validity_patterns[type::RTLevel::Base];
+    jp_vp.clear();
+    for (const auto& blocks: days) {
+        jp_vp.emplace_back(blocks.begin(), blocks.end());
+        jp_vp.back().resize(jp_container.nb_jps());
+    }
+    for (size_t vj_idx = persisted.nb_vjs; vj_idx < data.vehicle_journeys.size(); ++vj_idx) {
+        const auto& vj = *data.vehicle_journeys[vj_idx];
+        const auto jp_idx = jp_container.get_jp_from_vj()[VjIdx(vj)];
+        for (int i = 0; i <= 365; ++i) {
+            if (vj.validity_patterns[type::RTLevel::Base]->check2(i)) { jp_vp[i].set(jp_idx.val); }
+        }
+    }
+    load_jp_validity_patterns(type::RTLevel::Adapted);
+    load_jp_validity_patterns(type::RTLevel::RealTime);
+
+    load_from_jps(data, cache_size);
+    return true;
+}
+
+PersistedRaptor dataRAPTOR::make_persisted(const type::PT_Data& data) const {
+    PersistedRaptor res;
+    res.version = PersistedRaptor::current_version;
+    res.nb_vjs = data.vehicle_journeys.size();
+    res.vp_fingerprint = vp_fingerprint(data, res.nb_vjs);
+    res.jp_vjs = jp_container.get_vjs_idx();
+    res.jp_validity_patterns.emplace_back();
+    for (const auto& day_vp: jp_validity_patterns[type::RTLevel::Base]) {
+        res.jp_validity_patterns.back().emplace_back();
+        boost::to_block_range(day_vp, std::back_inserter(res.jp_validity_patterns.back().back()));
+    }
+    return res;
+}
+
+void dataRAPTOR::load_jp_validity_patterns() {
+    for (const auto rt_level: rt_levels) {
+        load_jp_validity_patterns(rt_level);
+    }
+}
+
+void dataRAPTOR::load_jp_validity_patterns(type::RTLevel rt_level) {
+    auto& jp_vp = jp_validity_patterns[rt_level];
+    jp_vp.assign(366, boost::dynamic_bitset<>(jp_container.nb_jps()));
+    for (const auto& jp: jp_container.get_jps()) {
+        for (int i = 0; i <= 365; ++i) {
+            jp.second.for_each_vehicle_journey([&](const nt::VehicleJourney& vj) {
+                if (vj.validity_patterns[rt_level]->check2(i)) {
+                    jp_vp[i].set(jp.first.val);
+                    return false;
+                }
+                return true;
+            });
+        }
+    }
+}
+
+// everything that is linear in the size of the jps
+void dataRAPTOR::load_from_jps(const type::PT_Data& data, size_t cache_size) {
     labels_const.init_inf(data.stop_points);
     labels_const_reverse.init_min(data.stop_points);
 
     connections.load(data);
     jpps_from_sp.load(data, jp_container);
     jpps_from_jp.load(jp_container);
+    route_points.load(jp_container);
+    calendar_stop_times.load(jp_container);
     next_stop_time_data.load(jp_container);
 
-    for (auto level_cont: jp_validity_patterns) {
-        const auto rt_level = level_cont.first;
-        auto& jp_vp = level_cont.second;
-        jp_vp.assign(366, boost::dynamic_bitset<>(jp_container.nb_jps()));
-        for (const auto& jp: jp_container.get_jps()) {
-            for (int i = 0; i <= 365; ++i) {
-                jp.second.for_each_vehicle_journey([&](const nt::VehicleJourney& vj) {
-                    if (vj.validity_patterns[rt_level]->check2(i)) {
-                        jp_vp[i].set(jp.first.val);
-                        return false;
-                    }
-                    return true;
-                });
-            }
-        }
-    }
-
     min_connection_time = std::numeric_limits<uint32_t>::max();
     for (const auto& conns : connections.forward_connections) {
         for (const auto& conn : conns.second) {
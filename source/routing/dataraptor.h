@@ -38,9 +38,37 @@ www.navitia.io
 
 #include <boost/foreach.hpp>
 #include <boost/dynamic_bitset.hpp>
+#include <map>
+#include <unordered_map>
 
 namespace navitia { namespace routing {
 
+/** The part of dataRAPTOR that is long to compute: the grouping of the
+  * vjs in jps (with the overtaking checks) and the validity patterns
+  * of the jps.  It is saved in the data.nav to skip its computation
+  * when kraken loads the data. */
+struct PersistedRaptor {
+    // *INCREMENT* when the content or the way it is computed changes
+    static const uint32_t current_version = 2;
+    uint32_t version = 0;
+
+    // to check that the data are the ones used to compute it: the first
+    // nb_vjs vjs of pt_data and their base validity patterns. The vjs created
+    // after (by the disruptions applied at load) are not persisted.
+    size_t nb_vjs = 0;
+    size_t vp_fingerprint = 0;
+
+    // the vj indexes of each jp, covering the nb_vjs first vjs
+    std::vector<std::vector<idx_t>> jp_vjs;
+    // the blocks of the jp validity patterns, [0][day] for the base level only
+    using Blocks = std::vector<boost::dynamic_bitset<>::block_type>;
+    std::vector<std::vector<Blocks>> jp_validity_patterns;
+
+    template<class Archive> void serialize(Archive& ar, const unsigned int) {
+        ar & version & nb_vjs & vp_fingerprint & jp_vjs & jp_validity_patterns;
+    }
+};
+
 /** Données statiques qui ne sont pas modifiées pendant le calcul */
 struct dataRAPTOR {
 
@@ -100,6 +128,38 @@ struct dataRAPTOR {
     };
     JppsFromJp jpps_from_jp;
 
+    // the JourneyPatternPoints grouped by (StopPoint, Route), for the schedules
+    struct RoutePoints {
+        struct RoutePoint {
+            SpIdx sp_idx;
+            RouteIdx route_idx;
+            std::vector<JppIdx> jpps;
+        };
+        // index of the route point of a jpp
+        inline size_t operator[](const JppIdx& jpp) const {
+            return route_point_of_jpp[jpp];
+        }
+        inline const RoutePoint& get(const size_t idx) const { return route_points[idx]; }
+        inline size_t size() const { return route_points.size(); }
+        void load(const JourneyPatternContainer&);
+    private:
+        std::vector<RoutePoint> route_points;
+        IdxMap<JourneyPatternPoint, size_t> route_point_of_jpp;
+    };
+    RoutePoints route_points;
+
+    // for each calendar, the stop times of the jpps (one theoric vj by meta vj
+    // associated to the calendar), sorted by their time in the day
+    struct CalendarStopTimes {
+        using TimeSt = std::pair<uint32_t, const type::StopTime*>;
+        // nullptr if no vj of the jpp is associated to the calendar
+        const std::vector<TimeSt>* get(const JppIdx& jpp, const std::string& calendar_id) const;
+        void load(const JourneyPatternContainer&);
+    private:
+        std::unordered_map<std::string, std::map<JppIdx, std::vector<TimeSt>>> stop_times;
+    };
+    CalendarStopTimes calendar_stop_times;
+
     NextStopTimeData next_stop_time_data;
     std::unique_ptr<CachedNextStopTimeManager> cached_next_st_manager;
 
@@ -114,6 +174,17 @@ struct dataRAPTOR {
 
     dataRAPTOR() {}
     void load(const navitia::type::PT_Data&, size_t cache_size = 10);
+
+    // load using a PersistedRaptor, returns false (and nothing is
+    // loaded) if it does not correspond to the data.  The vjs added
+    // after the persisted ones are grouped in jps as in the full load.
+    bool load(const navitia::type::PT_Data&, const PersistedRaptor&, size_t cache_size = 10);
+    PersistedRaptor make_persisted(const navitia::type::PT_Data&) const;
+
+private:
+    void load_jp_validity_patterns();
+    void load_jp_validity_patterns(type::RTLevel);
+    void load_from_jps(const navitia::type::PT_Data&, size_t cache_size);
 };
 
 }}
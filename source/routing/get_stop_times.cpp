@@ -44,29 +44,47 @@ std::vector<datetime_stop_time> get_stop_times(const routing::StopEvent stop_eve
                                                const type::Data& data, 
                                                const type::RTLevel rt_level,
                                                const type::AccessibiliteParams& accessibilite_params) {
+    auto result = get_stop_times(stop_event, std::vector<std::vector<routing::JppIdx>>{journey_pattern_points},
+                                 dt, max_dt, max_departures, data, rt_level, accessibilite_params);
+    return std::move(result.front());
+}
+
+std::vector<std::vector<datetime_stop_time>>
+get_stop_times(const routing::StopEvent stop_event,
+               const std::vector<std::vector<routing::JppIdx>>& jpps_by_group,
+               const DateTime& dt,
+               const DateTime& max_dt,
+               const size_t max_departures,
+               const type::Data& data,
+               const type::RTLevel rt_level,
+               const type::AccessibiliteParams& accessibilite_params) {
     const bool clockwise(max_dt >= dt);
-    std::vector<datetime_stop_time> result;
+    std::vector<std::vector<datetime_stop_time>> result(jpps_by_group.size());
     routing::NextStopTime next_st = routing::NextStopTime(data);
 
     // Next departure for the next stop: we store it to have the next departure for each jpp
-    // We init it with the next_stop_time for each jpp
-    JppStQueue next_requested_dt({clockwise});
-    for (const auto& jpp_idx : journey_pattern_points) {
-        const routing::JourneyPatternPoint& jpp = data.dataRaptor->jp_container.get(jpp_idx);
-        if (! data.pt_data->stop_points[jpp.sp_idx.val]->accessible(accessibilite_params.properties)) {
-            // we do not push them in the queue at all
-            continue;
-        }
-        auto st = next_st.next_stop_time(stop_event, jpp_idx,
-                                         dt, clockwise, rt_level,
-                                         accessibilite_params.vehicle_properties, true);
+    // We init it with the next_stop_time for each jpp of each group
+    GroupJppStQueue next_requested_dt({clockwise});
+    for (size_t group = 0; group < jpps_by_group.size(); ++group) {
+        if (max_departures == 0) { break; }
+        for (const auto& jpp_idx : jpps_by_group[group]) {
+            const routing::JourneyPatternPoint& jpp = data.dataRaptor->jp_container.get(jpp_idx);
+            if (! data.pt_data->stop_points[jpp.sp_idx.val]->accessible(accessibilite_params.properties)) {
+                // we do not push them in the queue at all
+                continue;
+            }
+            auto st = next_st.next_stop_time(stop_event, jpp_idx,
+                                             dt, clockwise, rt_level,
+                                             accessibilite_params.vehicle_properties, true);
 
-        if (st.first) {
-            next_requested_dt.push({jpp_idx, st.first, st.second});
+            if (st.first) {
+                next_requested_dt.emplace(JppSt{jpp_idx, st.first, st.second}, group);
+            }
         }
     }
 
-    while (! next_requested_dt.empty() && result.size() < max_departures) {
+    size_t nb_full_groups = 0;
+    while (! next_requested_dt.empty() && nb_full_groups < result.size()) {
         const auto best_jpp_dt = next_requested_dt.top(); // copy
         next_requested_dt.pop();
         if ((clockwise && best_jpp_dt.dt > max_dt) ||
@@ -74,7 +92,16 @@ std::vector<datetime_stop_time> get_stop_times(const routing::StopEvent stop_eve
             // the best elt of the queue is after the limit, we can stop
             break;
         }
-        result.push_back(std::make_pair(best_jpp_dt.dt, best_jpp_dt.st));
+        auto& group_result = result[best_jpp_dt.group];
+        if (group_result.size() >= max_departures) {
+            // the group is full, its remaining jpps are forgotten
+            continue;
+        }
+        group_result.push_back(std::make_pair(best_jpp_dt.dt, best_jpp_dt.st));
+        if (group_result.size() == max_departures) {
+            ++nb_full_groups;
+            continue;
+        }
 
         // we insert the next stop time in the queue (it must be at least one second after/before)
         auto next_dt = best_jpp_dt.dt + (clockwise ? 1 : -1);
@@ -82,7 +109,7 @@ std::vector<datetime_stop_time> get_stop_times(const routing::StopEvent stop_eve
                                          next_dt, clockwise, rt_level,
                                          accessibilite_params.vehicle_properties, true);
         if (st.first) {
-            next_requested_dt.push({best_jpp_dt.jpp, st.first, st.second});
+            next_requested_dt.emplace(JppSt{best_jpp_dt.jpp, st.first, st.second}, best_jpp_dt.group);
         }
     }
 
@@ -98,33 +125,42 @@ get_stop_times(const std::vector<routing::JppIdx>& journey_pattern_points,
                const std::string calendar_id,
                const type::AccessibiliteParams& accessibilite_params) {
     std::vector<datetime_stop_time> result;
+    using TimeSt = dataRAPTOR::CalendarStopTimes::TimeSt;
+    const auto add_accessibles = [&](std::vector<TimeSt>::const_iterator begin,
+                                     std::vector<TimeSt>::const_iterator end) {
+        for (auto it = begin; it != end; ++it) {
+            if (it->second->vehicle_journey->accessible(accessibilite_params.vehicle_properties)) {
+                result.push_back(*it);
+            }
+        }
+    };
+    const auto hour_less = [](const TimeSt& st, uint32_t time) { return DateTimeUtils::hour(st.first) < time; };
+    const auto less_hour = [](uint32_t time, const TimeSt& st) { return time < DateTimeUtils::hour(st.first); };
 
     for(auto jpp_idx : journey_pattern_points) {
         const routing::JourneyPatternPoint& jpp = data.dataRaptor->jp_container.get(jpp_idx);
         if (!data.pt_data->stop_points[jpp.sp_idx.val]->accessible(accessibilite_params.properties)) {
             continue;
         }
-        auto st = get_all_stop_times(data.dataRaptor->jp_container.get(jpp.jp_idx),
-                                     jpp,
-                                     calendar_id,
-                                     accessibilite_params.vehicle_properties);
+        // the stop times of the calendar are sorted by their time in the day
+        const auto* st = data.dataRaptor->calendar_stop_times.get(jpp_idx, calendar_id);
+        if (! st) { continue; }
 
         //afterward we filter the datetime not in [dt, max_dt]
         //the difficult part comes from the fact that, for calendar, 'dt' and 'max_dt' are not really datetime,
         //there are time but max_dt can be the day after like [today 4:00, tomorow 3:00]
-        for (auto& res: st) {
-            auto time = DateTimeUtils::hour(res.first);
-            if (max_time > begining_time) {
-                // we keep the st in [dt, max_dt]
-                if (time >= begining_time && time <= max_time) {
-                    result.push_back(res);
-                }
-            } else {
-                // we filter the st in ]max_dt, dt[
-                if (time >= begining_time || time <= max_time) {
-                    result.push_back(res);
-                }
-            }
+        const auto first = std::lower_bound(st->begin(), st->end(), begining_time, hour_less);
+        const auto last = std::upper_bound(st->begin(), st->end(), max_time, less_hour);
+        if (max_time > begining_time) {
+            // we keep the st in [dt, max_dt]
+            add_accessibles(first, last);
+        } else if (last > first) {
+            // dt == max_dt, the whole day
+            add_accessibles(st->begin(), st->end());
+        } else {
+            // we filter the st in ]max_dt, dt[
+            add_accessibles(st->begin(), last);
+            add_accessibles(first, st->end());
         }
     }
 
@@ -164,39 +200,45 @@ get_all_stop_times(const routing::JourneyPattern& jp,
         return {};
     }
 
-    std::vector<std::pair<DateTime, const type::StopTime*>> res;
+    std::vector<std::pair<uint32_t, const type::StopTime*>> res;
     for (const auto vj: vjs) {
-        //loop through stop times for stop jpp->stop_point
-        const auto& st = vj->stop_time_list[jpp.order];
-        if (! st.vehicle_journey->accessible(vehicle_properties)) {
+        if (! vj->accessible(vehicle_properties)) {
             continue; //the stop time must be accessible
         }
-        if (st.is_frequency()) {
-            //if it is a frequency, we got to expand the timetable
-
-            //Note: end can be lower than start, so we have to cycle through the day
-            const auto freq_vj = static_cast<const type::FrequencyVehicleJourney*>(vj);
-            bool is_looping = (freq_vj->start_time > freq_vj->end_time);
-            auto stop_loop = [freq_vj, is_looping](u_int32_t t) {
-                if (! is_looping)
-                    return t <= freq_vj->end_time;
-                return t > freq_vj->end_time;
-            };
-            for (auto time = freq_vj->start_time; stop_loop(time); time += freq_vj->headway_secs) {
-                if (is_looping && time > DateTimeUtils::SECONDS_PER_DAY) {
-                    time -= DateTimeUtils::SECONDS_PER_DAY;
-                }
-
-                //we need to convert this to local there since we do not have a precise date (just a period)
-                res.push_back({time + freq_vj->utc_to_local_offset(), &st});
-            }
-        } else {
-            //same utc tranformation
-            res.push_back({st.departure_time + vj->utc_to_local_offset(), &st});
-        }
+        add_stop_times_in_day(*vj, jpp, res);
     }
 
     return res;
 }
 
+void add_stop_times_in_day(const type::VehicleJourney& vj,
+                           const routing::JourneyPatternPoint& jpp,
+                           std::vector<std::pair<uint32_t, const type::StopTime*>>& res) {
+    //loop through stop times for stop jpp->stop_point
+    const auto& st = vj.stop_time_list[jpp.order];
+    if (st.is_frequency()) {
+        //if it is a frequency, we got to expand the timetable
+
+        //Note: end can be lower than start, so we have to cycle through the day
+        const auto freq_vj = static_cast<const type::FrequencyVehicleJourney*>(&vj);
+        bool is_looping = (freq_vj->start_time > freq_vj->end_time);
+        auto stop_loop = [freq_vj, is_looping](u_int32_t t) {
+            if (! is_looping)
+                return t <= freq_vj->end_time;
+            return t > freq_vj->end_time;
+        };
+        for (auto time = freq_vj->start_time; stop_loop(time); time += freq_vj->headway_secs) {
+            if (is_looping && time > DateTimeUtils::SECONDS_PER_DAY) {
+                time -= DateTimeUtils::SECONDS_PER_DAY;
+            }
+
+            //we need to convert this to local there since we do not have a precise date (just a period)
+            res.push_back({time + freq_vj->utc_to_local_offset(), &st});
+        }
+    } else {
+        //same utc tranformation
+        res.push_back({st.departure_time + vj.utc_to_local_offset(), &st});
+    }
+}
+
 }} // namespace navitia::timetables
@@ -59,6 +59,22 @@ get_stop_times(const routing::StopEvent stop_event,
                const type::RTLevel rt_level,
                const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams());
 
+/**
+ * @brief get_stop_times: the same for several groups of journey pattern points at once,
+ * the departures of all the groups are merged in one pass with a shared NextStopTime
+ * @param jpps_by_group: the journey pattern points of each group
+ * @param max_departures: max number of departure by group
+ * @return: for each group, the list of pair <datetime, departure st.idx> sorted on the datetimes
+ */
+std::vector<std::vector<datetime_stop_time>>
+get_stop_times(const routing::StopEvent stop_event,
+               const std::vector<std::vector<routing::JppIdx>>& jpps_by_group,
+               const DateTime& dt,
+               const DateTime& max_dt,
+               const size_t max_departures,
+               const type::Data& data,
+               const type::RTLevel rt_level,
+               const type::AccessibiliteParams& accessibilite_params = type::AccessibiliteParams());
 
 std::vector<datetime_stop_time>
 get_stop_times(const std::vector<routing::JppIdx>& journey_pattern_points,
@@ -75,6 +91,10 @@ get_all_stop_times(const routing::JourneyPattern& jp,
                    const std::string calendar_id,
                    const type::VehicleProperties& vehicle_properties = type::VehicleProperties());
 
+/// Add the {time in the day, stoptime} of the vj at the jpp to res (the frequencies are expanded)
+void add_stop_times_in_day(const type::VehicleJourney& vj,
+                           const routing::JourneyPatternPoint& jpp,
+                           std::vector<std::pair<uint32_t, const type::StopTime*>>& res);
 
 struct JppSt {
     routing::JppIdx jpp;
@@ -97,6 +117,13 @@ struct BestDTComp {
 
 using JppStQueue = std::priority_queue<JppSt, std::vector<JppSt>, BestDTComp>;
 
+// a JppSt of a group, for the batched get_stop_times
+struct GroupJppSt: JppSt {
+    GroupJppSt(const JppSt& jpp_st, size_t group): JppSt(jpp_st), group(group) {}
+    size_t group;
+};
+using GroupJppStQueue = std::priority_queue<GroupJppSt, std::vector<GroupJppSt>, BestDTComp>;
+
 
 /*
  * for schedule with calendar, we want to sort the result a quite a strange way
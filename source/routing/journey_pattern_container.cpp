@@ -32,6 +32,7 @@ www.navitia.io
 #include "type/pt_data.h"
 #include "tests/utils_test.h"
 #include <type_traits>
+#include <algorithm>
 
 namespace navitia { namespace routing {
 
@@ -65,6 +66,76 @@ void JourneyPatternContainer::load(const nt::PT_Data& pt_data) {
     }
 }
 
+bool JourneyPatternContainer::load(const nt::PT_Data& pt_data,
+                                   const std::vector<std::vector<idx_t>>& jp_vjs) {
+    map.clear();
+    jps.clear();
+    jpps.clear();
+    jps_from_route.assign(pt_data.routes);
+    jp_from_vj.assign(pt_data.vehicle_journeys);
+    jps_from_phy_mode.assign(pt_data.physical_modes);
+
+    // the persisted vjs are the first ones of pt_data
+    size_t nb_persisted_vjs = 0;
+    for (const auto& vjs: jp_vjs) { nb_persisted_vjs += vjs.size(); }
+    std::vector<bool> is_loaded(pt_data.vehicle_journeys.size(), false);
+    auto ok = [&]() {
+        if (nb_persisted_vjs > pt_data.vehicle_journeys.size()) { return false; }
+        for (const auto& vjs: jp_vjs) {
+            if (vjs.empty()) { return false; }
+            boost::optional<JpIdx> jp_idx;
+            boost::optional<JpKey> jp_key;
+            for (const auto vj_idx: vjs) {
+                if (vj_idx >= nb_persisted_vjs || is_loaded[vj_idx]) { return false; }
+                is_loaded[vj_idx] = true;
+                const auto* vj = pt_data.vehicle_journeys[vj_idx];
+                if (const auto* dvj = dynamic_cast<const nt::DiscreteVehicleJourney*>(vj)) {
+                    if (! add_vj_to_jp(*dvj, jp_idx, jp_key)) { return false; }
+                } else if (const auto* fvj = dynamic_cast<const nt::FrequencyVehicleJourney*>(vj)) {
+                    if (! add_vj_to_jp(*fvj, jp_idx, jp_key)) { return false; }
+                } else {
+                    return false;
+                }
+            }
+        }
+        // the vjs are all different and fewer than nb_persisted_vjs, so they are all loaded
+        return true;
+    }();
+
+    if (! ok) {
+        map.clear();
+        jps.clear();
+        jpps.clear();
+        jps_from_route.assign(pt_data.routes);
+        jp_from_vj.assign(pt_data.vehicle_journeys);
+        jps_from_phy_mode.assign(pt_data.physical_modes);
+        return false;
+    }
+    // the vjs created since (e.g. by the disruptions applied at load) are grouped as usual
+    for (const auto* route: pt_data.routes) {
+        for (const auto& vj: route->discrete_vehicle_journey_list) {
+            if (! is_loaded[vj->idx]) { add_vj(*vj); }
+        }
+        for (const auto& vj: route->frequency_vehicle_journey_list) {
+            if (! is_loaded[vj->idx]) { add_vj(*vj); }
+        }
+    }
+    return true;
+}
+
+std::vector<std::vector<idx_t>> JourneyPatternContainer::get_vjs_idx() const {
+    std::vector<std::vector<idx_t>> res;
+    res.reserve(jps.size());
+    for (const auto& jp: jps) {
+        res.emplace_back();
+        jp.for_each_vehicle_journey([&](const nt::VehicleJourney& vj) {
+            res.back().push_back(vj.idx);
+            return true;
+        });
+    }
+    return res;
+}
+
 const JppIdx& JourneyPatternContainer::get_jpp(const type::StopTime& st) const {
     const auto& jp = get(jp_from_vj[VjIdx(*st.vehicle_journey)]);
     return jp.jpps.at(st.order());
@@ -189,6 +260,28 @@ void JourneyPatternContainer::add_vj(const VJ& vj) {
     jp_from_vj[VjIdx(vj)] = jp_idx;
 }
 
+// Adds vj in the given jp, creating it if needed.  As the overtaking
+// is not checked, the vjs must have been grouped by add_vj before.
+template<typename VJ>
+bool JourneyPatternContainer::add_vj_to_jp(const VJ& vj,
+                                           boost::optional<JpIdx>& jp_idx,
+                                           boost::optional<JpKey>& jp_key) {
+    auto key = make_key(vj);
+    if (jp_key) {
+        // all the vjs of a jp must have the same key
+        if (*jp_key < key || key < *jp_key) { return false; }
+    } else {
+        jp_idx = make_jp(key);
+        map[key].push_back(*jp_idx);
+        jps_from_route[key.route_idx].push_back(*jp_idx);
+        jps_from_phy_mode[key.phy_mode_idx].push_back(*jp_idx);
+        jp_key = std::move(key);
+    }
+    get_mut(*jp_idx).template get_vjs<VJ>().push_back(&vj);
+    jp_from_vj[VjIdx(vj)] = *jp_idx;
+    return true;
+}
+
 JpIdx JourneyPatternContainer::make_jp(const JpKey& key) {
     const auto jp_idx = JpIdx(jps.size());
     JourneyPattern jp;
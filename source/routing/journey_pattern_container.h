@@ -88,6 +88,13 @@ struct JourneyPatternContainer {
     using JppRange = boost::iterator_range<JppIterator>;
 
     void load(const navitia::type::PT_Data&);
+    // Loads the jps from the vjs of each jp (as given by get_vjs_idx),
+    // without the overtaking computation, the vjs of pt_data after them
+    // are then added as in load.  Returns false (and the container is
+    // empty) if it does not match pt_data.
+    bool load(const navitia::type::PT_Data&, const std::vector<std::vector<idx_t>>& jp_vjs);
+    // The vj indexes of each jp, discrete vjs first, in order.
+    std::vector<std::vector<idx_t>> get_vjs_idx() const;
     size_t nb_jps() const { return jps.size(); }
     size_t nb_jpps() const { return jpps.size(); }
     const JourneyPattern& get(const JpIdx& idx) const {
@@ -181,6 +188,7 @@ private:
     IdxMap<type::PhysicalMode, std::vector<JpIdx>> jps_from_phy_mode;
 
     template<typename VJ> void add_vj(const VJ&);
+    template<typename VJ> bool add_vj_to_jp(const VJ&, boost::optional<JpIdx>&, boost::optional<JpKey>&);
     template<typename VJ> static JpKey make_key(const VJ&);
     JpIdx make_jp(const JpKey&);
     JppIdx make_jpp(const JpIdx&, const SpIdx&, uint16_t order);
@@ -37,6 +37,8 @@ www.navitia.io
 
 #include <boost/range/algorithm/sort.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
+#include <exception>
+#include <thread>
 
 namespace navitia { namespace routing {
 
@@ -514,6 +516,24 @@ CachedNextStopTimeManager::load(const DateTime from,
     return lru(key);
 }
 
+void CachedNextStopTimeManager::warmup(const std::vector<CachedNextStopTimeKey>& keys) {
+    std::vector<std::exception_ptr> errors(keys.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            try {
+                lru(keys[i]);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread: threads) { thread.join(); }
+    for (const auto& error: errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+}
+
 inline static bool within(u_int32_t val, std::pair<u_int32_t, u_int32_t> bound) {
     return val >= bound.first && val <= bound.second;
 }
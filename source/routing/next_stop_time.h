@@ -277,6 +277,13 @@ struct CachedNextStopTimeManager {
          const type::RTLevel rt_level,
          const type::AccessibiliteParams& accessibilite_params);
 
+    // Builds the caches of the given keys, one thread per key, so that
+    // the first requests don't have to.  The first exception is thrown
+    // once all the caches are built.
+    void warmup(const std::vector<CachedNextStopTimeKey>& keys);
+
+    size_t get_nb_cache_miss() { return lru.get_nb_cache_miss(); }
+
 private:
     struct CacheCreator {
         typedef CachedNextStopTimeKey const& argument_type;
@@ -141,6 +141,39 @@ bool RAPTOR::foot_path(const Visitor& v) {
 }
 
 
+RAPTOR::RAPTOR(const navitia::type::Data& data, RAPTOR&& previous) :
+    data(data),
+    labels(std::move(previous.labels)),
+    first_pass_labels(std::move(previous.first_pass_labels)),
+    best_labels_pts(std::move(previous.best_labels_pts)),
+    best_labels_transfers(std::move(previous.best_labels_transfers)),
+    count(0),
+    valid_journey_patterns(std::move(previous.valid_journey_patterns)),
+    jpps_from_sp(std::move(previous.jpps_from_sp)),
+    Q(std::move(previous.Q)),
+    valid_stop_points(std::move(previous.valid_stop_points)),
+    deadline(previous.deadline)
+{
+    // labels, Q and jpps_from_sp are copied from dataRaptor at each
+    // computation, only the other ones depend on the sizes
+    if (! is_compatible(data)) {
+        best_labels_pts.assign(data.pt_data->stop_points);
+        best_labels_transfers.assign(data.pt_data->stop_points);
+        valid_journey_patterns.resize(data.dataRaptor->jp_container.nb_jps());
+        valid_stop_points.resize(data.pt_data->stop_points.size());
+        Q.assign(data.dataRaptor->jp_container.get_jps_values());
+        labels.assign(10, data.dataRaptor->labels_const);
+        first_pass_labels.assign(10, data.dataRaptor->labels_const);
+    }
+}
+
+bool RAPTOR::is_compatible(const navitia::type::Data& other) const {
+    return best_labels_pts.values().size() == other.pt_data->stop_points.size()
+        && best_labels_transfers.values().size() == other.pt_data->stop_points.size()
+        && valid_stop_points.size() == other.pt_data->stop_points.size()
+        && valid_journey_patterns.size() == other.dataRaptor->jp_container.nb_jps();
+}
+
 void RAPTOR::clear(const bool clockwise, const DateTime bound) {
     const int queue_value = clockwise ?  std::numeric_limits<int>::max() : -1;
     Q.assign(data.dataRaptor->jp_container.get_jps_values(), queue_value);
@@ -435,6 +468,7 @@ RAPTOR::compute_all(const map_stop_point_duration& departures,
 
     size_t nb_snd_pass = 0, nb_useless= 0, last_usefull_2nd_pass = 0, supplementary_2nd_pass = 0;
     for (const auto& start: starting_points) {
+        deadline.check("raptor second pass");
         Journey fake_journey = convert_to_bound(start,
                                                 lower_bound_fb,
                                                 data.dataRaptor->min_connection_time,
@@ -638,6 +672,8 @@ void RAPTOR::raptor_loop(Visitor visitor,
     count = 0; //< Count iteration of raptor algorithm
 
     while(continue_algorithm && count <= max_transfers) {
+        // one check by round is cheap compared to a round
+        deadline.check("raptor");
         ++count;
         continue_algorithm = false;
         if(count == labels.size()) {
@@ -42,6 +42,7 @@ www.navitia.io
 #include "dataraptor.h"
 #include "raptor_utils.h"
 #include "type/time_duration.h"
+#include "type/deadline.h"
 
 namespace navitia { namespace routing {
 
@@ -91,6 +92,9 @@ struct RAPTOR
     // set to store if the stop_point is valid
     boost::dynamic_bitset<> valid_stop_points;
 
+    /// the computation is aborted with a DeadlineExpired once it is exceeded
+    Deadline deadline;
+
     explicit RAPTOR(const navitia::type::Data& data) :
         data(data),
         best_labels_pts(data.pt_data->stop_points),
@@ -104,6 +108,14 @@ struct RAPTOR
         first_pass_labels.assign(10, data.dataRaptor->labels_const);
     }
 
+    /// Rebinds the state of previous (built on another data) to data.
+    /// Its allocations are reused, and resized only if the number of
+    /// stop points or journey patterns has changed.
+    RAPTOR(const navitia::type::Data& data, RAPTOR&& previous);
+
+    /// Can the state of this RAPTOR be used for data without being resized?
+    bool is_compatible(const navitia::type::Data& data) const;
+
     void clear(bool clockwise, DateTime bound);
 
     ///Initialize starting points
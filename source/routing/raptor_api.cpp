@@ -301,7 +301,8 @@ static bt::ptime get_base_dt(const nt::StopTime* st_orig, const nt::StopTime* st
 
 static bt::ptime handle_pt_sections(pbnavitia::Journey* pb_journey,
                                     PbCreator& pb_creator,
-                                    const navitia::routing::Path& path){
+                                    const navitia::routing::Path& path,
+                                    const fare::results& fare){
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     pb_journey->set_nb_transfers(path.nb_changes);
     pb_journey->set_requested_date_time(navitia::to_posix_timestamp(path.request_time));
@@ -474,8 +475,7 @@ static bt::ptime handle_pt_sections(pbnavitia::Journey* pb_journey,
 
     compute_most_serious_disruption(pb_journey, pb_creator);
 
-    //fare computation, done at the end for the journey to be complete
-    auto fare = pb_creator.data.fare->compute_fare(path);
+    //fare computed with the other journeys of the response
     try {
         pb_creator.fill_fare_section(pb_journey, fare);
     } catch(const navitia::exception& e) {
@@ -496,7 +496,9 @@ static void add_pathes(PbCreator& pb_creator,
 
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
 
-    for(const Path& path : paths) {
+    const auto fares = pb_creator.data.fare->compute_fares(paths);
+    for (size_t path_idx = 0; path_idx < paths.size(); ++path_idx) {
+        const Path& path = paths[path_idx];
         bt::ptime arrival_time = bt::pos_infin;
         if (path.items.empty()) {
             continue;
@@ -574,7 +576,7 @@ static void add_pathes(PbCreator& pb_creator,
             }
         }
 
-        arrival_time = handle_pt_sections(pb_journey, pb_creator, path);
+        arrival_time = handle_pt_sections(pb_journey, pb_creator, path, fares[path_idx]);
         // for 'taxi like' odt, we want to start from the address, not the 1 stop point
         if (journey_begin_with_address_odt) {
             auto* section = pb_journey->mutable_sections(0);
@@ -678,14 +680,16 @@ static void add_pt_pathes(PbCreator& pb_creator,
                        const std::vector<navitia::routing::Path>& paths) {
 
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
-    for(const Path& path : paths) {
+    const auto fares = pb_creator.data.fare->compute_fares(paths);
+    for (size_t path_idx = 0; path_idx < paths.size(); ++path_idx) {
+        const Path& path = paths[path_idx];
         //TODO: what do we want to do in this case?
         if (path.items.empty()) {
             continue;
         }
         bt::ptime departure_time = path.items.front().departures.front();
         pbnavitia::Journey* pb_journey = pb_creator.add_journeys();
-        bt::ptime arrival_time = handle_pt_sections(pb_journey, pb_creator, path);
+        bt::ptime arrival_time = handle_pt_sections(pb_journey, pb_creator, path, fares[path_idx]);
 
 
         pb_journey->set_departure_date_time(navitia::to_posix_timestamp(departure_time));
@@ -35,6 +35,8 @@ www.navitia.io
 #include "routing/get_stop_times.h"
 #include "ed/build_helper.h"
 #include "routing/dataraptor.h"
+#include <set>
+#include <boost/range/algorithm/sort.hpp>
 
 using namespace navitia;
 using namespace navitia::routing;
@@ -78,6 +80,41 @@ BOOST_AUTO_TEST_CASE(test1){
 
 }
 
+BOOST_AUTO_TEST_CASE(batched_stop_times) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.vj("A")("stop1", 9000, 9050)("stop2", 9100, 9150);
+    b.vj("A")("stop1", 10000, 10050)("stop2", 10100, 10150);
+    b.vj("B")("stop1", 8500, 8550)("stop3", 8600, 8650);
+    b.finish();
+    b.data->pt_data->index();
+    b.data->build_raptor();
+
+    // the jpps of stop1 are grouped by route
+    const auto& route_points = b.data->dataRaptor->route_points;
+    const auto sp_idx = SpIdx(*b.data->pt_data->stop_points_map["stop1"]);
+    std::vector<std::vector<JppIdx>> groups;
+    std::set<size_t> seen;
+    for (const auto& jpp: b.data->dataRaptor->jpps_from_sp[sp_idx]) {
+        const auto& route_point = route_points.get(route_points[jpp.idx]);
+        BOOST_CHECK(route_point.sp_idx == sp_idx);
+        if (seen.insert(route_points[jpp.idx]).second) { groups.push_back(route_point.jpps); }
+    }
+    BOOST_REQUIRE_EQUAL(groups.size(), 2);
+
+    auto result = get_stop_times(StopEvent::pick_up, groups, navitia::DateTimeUtils::min,
+                                 navitia::DateTimeUtils::set(1, 0), 2, *b.data, nt::RTLevel::Base);
+    BOOST_REQUIRE_EQUAL(result.size(), 2);
+    for (size_t i = 0; i < groups.size(); ++i) {
+        // the same as a call by group
+        const auto expected = get_stop_times(StopEvent::pick_up, groups[i], navitia::DateTimeUtils::min,
+                                             navitia::DateTimeUtils::set(1, 0), 2, *b.data, nt::RTLevel::Base);
+        BOOST_CHECK(result[i] == expected);
+        BOOST_CHECK_LE(result[i].size(), 2);
+    }
+    BOOST_CHECK_EQUAL(result[0].size() + result[1].size(), 3);
+}
+
 /**
  * Test get_all_stop_times for one calendar
  *
@@ -143,6 +180,57 @@ BOOST_AUTO_TEST_CASE(test_calendar) {
     BOOST_CHECK_EQUAL(second_elt.second->stop_point->stop_area->name, spa1);
 }
 
+/**
+ * The calendar schedules read the sorted stop times of the calendar in the time window
+ *
+ * same data as test_calendar
+ */
+BOOST_AUTO_TEST_CASE(test_calendar_time_window) {
+    ed::builder b("20120614");
+    std::string spa1 = "stop1";
+    b.vj("A", "1010", "", true, "vj1")(spa1, 8000, 8000)("useless", 10000, 10000);
+    b.vj("A", "1010", "", true, "vj2")(spa1, 8100, 8100)("useless", 11000, 11000);
+    b.vj("A", "1111", "", true, "vj3")(spa1, 9000, 9000)("useless", 12000, 12000);
+
+    auto cal(new type::Calendar(b.data->meta->production_date.begin()));
+    cal->uri="cal1";
+
+    b.finish();
+
+    for (auto vj_name: {"vj1", "vj2"}) {
+        auto associated_cal = new type::AssociatedCalendar();
+        associated_cal->calendar = cal;
+        b.data->pt_data->meta_vjs.get_mut(vj_name)->associated_calendars.insert({cal->uri, associated_cal});
+    }
+
+    b.data->pt_data->index();
+    b.data->build_uri();
+    b.data->build_raptor();
+
+    const auto& jpp_idx = b.data->dataRaptor->jpps_from_sp[SpIdx(*b.data->pt_data->stop_points_map["stop1"])].front().idx;
+    const auto* stop_times = b.data->dataRaptor->calendar_stop_times.get(jpp_idx, "cal1");
+    BOOST_REQUIRE(stop_times != nullptr);
+    BOOST_REQUIRE_EQUAL(stop_times->size(), 2);
+    BOOST_CHECK_EQUAL(stop_times->at(0).first, 8000);
+    BOOST_CHECK_EQUAL(stop_times->at(1).first, 8100);
+    BOOST_CHECK(b.data->dataRaptor->calendar_stop_times.get(jpp_idx, "unknown") == nullptr);
+
+    auto departures = [&](uint32_t begin, uint32_t end) {
+        std::vector<uint32_t> res;
+        for (const auto& dt_st: get_stop_times({jpp_idx}, begin, end, *b.data, "cal1")) {
+            res.push_back(dt_st.first);
+        }
+        boost::sort(res);
+        return res;
+    };
+    BOOST_CHECK_EQUAL(departures(8050, 9500), std::vector<uint32_t>({8100}));
+    BOOST_CHECK_EQUAL(departures(7000, 8000), std::vector<uint32_t>({8000}));
+    // over midnight: [8050, 24:00[ and [0:00, 8000]
+    BOOST_CHECK_EQUAL(departures(8050, 8000), std::vector<uint32_t>({8000, 8100}));
+    BOOST_CHECK_EQUAL(departures(8200, 7000), std::vector<uint32_t>());
+    // the whole day
+    BOOST_CHECK_EQUAL(departures(8000, 8000), std::vector<uint32_t>({8000, 8100}));
+}
 
 /**
  * Test calendars
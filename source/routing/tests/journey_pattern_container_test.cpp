@@ -32,6 +32,7 @@ www.navitia.io
 #define BOOST_TEST_MODULE journey_pattern_container_test
 
 #include "routing/journey_pattern_container.h"
+#include "routing/dataraptor.h"
 #include "ed/build_helper.h"
 #include "tests/utils_test.h"
 #include "type/pt_data.h"
@@ -247,3 +248,38 @@ BOOST_AUTO_TEST_CASE(lightly_overtaking2) {
     BOOST_CHECK_EQUAL(jps.nb_jps(), 2);
 }
 
+
+// dataRAPTOR loaded from a PersistedRaptor is the same as the computed one
+BOOST_AUTO_TEST_CASE(persisted_raptor) {
+    ed::builder b("20150101");
+    b.vj("1", "000111")("A", "8:00"_t, "8:00"_t)("B", "8:10"_t, "8:10"_t)("C", "8:20"_t, "8:20"_t);
+    b.vj("1", "000111")("A", "8:05"_t, "8:05"_t)("B", "8:06"_t, "8:06"_t)("C", "8:30"_t, "8:30"_t);
+    b.vj("1", "111000")("A", "7:55"_t, "7:55"_t)("B", "8:15"_t, "8:15"_t)("C", "8:35"_t, "8:35"_t);
+    b.frequency_vj("1", "8:00"_t, "18:00"_t, "00:30"_t)("A", "8:00"_t)("B", "8:10"_t)("C", "8:20"_t);
+
+    b.data->pt_data->index();
+    b.finish();
+    b.data->build_raptor();
+    b.data->build_uri();
+    const nt::PT_Data& d = *b.data->pt_data;
+    const auto& raptor = *b.data->dataRaptor;
+
+    const auto persisted = raptor.make_persisted(d);
+    nr::dataRAPTOR loaded;
+    BOOST_REQUIRE(loaded.load(d, persisted));
+    BOOST_CHECK_EQUAL(check_jp_container(loaded.jp_container), 4);
+    BOOST_REQUIRE_EQUAL(loaded.jp_container.nb_jps(), raptor.jp_container.nb_jps());
+    for (const auto& jp: raptor.jp_container.get_jps()) {
+        BOOST_CHECK(loaded.jp_container.get(jp.first) == jp.second);
+    }
+    for (const auto level: {nt::RTLevel::Base, nt::RTLevel::Adapted, nt::RTLevel::RealTime}) {
+        BOOST_CHECK(loaded.jp_validity_patterns[level] == raptor.jp_validity_patterns[level]);
+    }
+    BOOST_CHECK(loaded.cached_next_st_manager);
+
+    // the validity patterns have changed, the persisted data are stale
+    b.data->pt_data->vehicle_journeys.front()->validity_patterns[nt::RTLevel::Base]->add(42);
+    nr::dataRAPTOR stale;
+    BOOST_CHECK(! stale.load(d, persisted));
+    BOOST_CHECK_EQUAL(stale.jp_container.nb_jps(), 0);
+}
@@ -2203,3 +2203,29 @@ BOOST_FIXTURE_TEST_CASE(test_get_next_dep_overnight_midnight_case, midnight_freq
 
     BOOST_REQUIRE_EQUAL(next_dt, DateTimeUtils::set(1, 17 * 60 * 60 + 30));
 }
+
+// the warmed up caches are not built again at the first request
+BOOST_AUTO_TEST_CASE(cache_warmup) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.finish();
+    b.data->pt_data->index();
+    b.data->build_uri();
+    b.data->build_raptor();
+    auto& manager = *b.data->dataRaptor->cached_next_st_manager;
+
+    const nt::AccessibiliteParams accessibility;
+    manager.warmup({{0, nt::RTLevel::Base, accessibility},
+                    {0, nt::RTLevel::RealTime, accessibility},
+                    {1, nt::RTLevel::Base, accessibility}});
+    BOOST_CHECK_EQUAL(manager.get_nb_cache_miss(), 3);
+
+    BOOST_CHECK(manager.load(DateTimeUtils::set(0, 8000), nt::RTLevel::Base, accessibility));
+    BOOST_CHECK(manager.load(DateTimeUtils::set(1, 0), nt::RTLevel::Base, accessibility));
+    BOOST_CHECK(manager.load(DateTimeUtils::set(0, 0), nt::RTLevel::RealTime, accessibility));
+    BOOST_CHECK_EQUAL(manager.get_nb_cache_miss(), 3);
+
+    // not warmed up
+    manager.load(DateTimeUtils::set(0, 0), nt::RTLevel::Adapted, accessibility);
+    BOOST_CHECK_EQUAL(manager.get_nb_cache_miss(), 4);
+}
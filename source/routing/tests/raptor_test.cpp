@@ -2889,3 +2889,75 @@ BOOST_AUTO_TEST_CASE(fix_datetime_represents_arrival_departure) {
     BOOST_CHECK_EQUAL(resp_0.at(0).items.front().stop_points.back()->uri,
                       resp_1.at(0).items.front().stop_points.back()->uri);
 }
+
+// a RAPTOR rebound to new data gives the results of the new data
+BOOST_AUTO_TEST_CASE(rebind_raptor_to_new_data) {
+    ed::builder b1("20120614");
+    b1.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b1.data->pt_data->index();
+    b1.finish();
+    b1.data->build_raptor();
+
+    // same topology, other times
+    ed::builder b2("20120614");
+    b2.vj("A")("stop1", 9000, 9050)("stop2", 9100, 9150);
+    b2.data->pt_data->index();
+    b2.finish();
+    b2.data->build_raptor();
+
+    // one more stop point
+    ed::builder b3("20120614");
+    b3.vj("A")("stop1", 9000, 9050)("stop2", 9100, 9150)("stop3", 9200, 9250);
+    b3.data->pt_data->index();
+    b3.finish();
+    b3.data->build_raptor();
+
+    auto raptor = std::make_unique<RAPTOR>(*b1.data);
+    auto res = raptor->compute(b1.data->pt_data->stop_areas[0], b1.data->pt_data->stop_areas[1], 7900, 0,
+                               DateTimeUtils::inf, type::RTLevel::Base, 2_min, true);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res.back().items[0].arrival.time_of_day().total_seconds(), 8100);
+
+    BOOST_CHECK(raptor->is_compatible(*b2.data));
+    BOOST_CHECK(! raptor->is_compatible(*b3.data));
+
+    raptor = std::make_unique<RAPTOR>(*b2.data, std::move(*raptor));
+    res = raptor->compute(b2.data->pt_data->stop_areas[0], b2.data->pt_data->stop_areas[1], 7900, 0,
+                          DateTimeUtils::inf, type::RTLevel::Base, 2_min, true);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res.back().items[0].arrival.time_of_day().total_seconds(), 9100);
+
+    raptor = std::make_unique<RAPTOR>(*b3.data, std::move(*raptor));
+    BOOST_CHECK(raptor->is_compatible(*b3.data));
+    res = raptor->compute(b3.data->pt_data->stop_areas[0], b3.data->pt_data->stop_areas[2], 7900, 0,
+                          DateTimeUtils::inf, type::RTLevel::Base, 2_min, true);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res.back().items[0].arrival.time_of_day().total_seconds(), 9200);
+}
+
+BOOST_AUTO_TEST_CASE(raptor_deadline) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.data->pt_data->index();
+    b.finish();
+    b.data->build_raptor();
+    RAPTOR raptor(*b.data);
+    const auto* sa1 = b.data->pt_data->stop_areas[0];
+    const auto* sa2 = b.data->pt_data->stop_areas[1];
+
+    // the deadline is far away, nothing changes
+    raptor.deadline.set_in(boost::posix_time::hours(1));
+    auto res = raptor.compute(sa1, sa2, 7900, 0, DateTimeUtils::inf, type::RTLevel::Base, 2_min, true);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+
+    // the deadline is exceeded, the computation is aborted
+    raptor.deadline = navitia::Deadline(boost::posix_time::microsec_clock::universal_time()
+                                        - boost::posix_time::seconds(1));
+    BOOST_CHECK_THROW(raptor.compute(sa1, sa2, 7900, 0, DateTimeUtils::inf, type::RTLevel::Base, 2_min, true),
+                      navitia::DeadlineExpired);
+
+    // without deadline the computation is never aborted
+    raptor.deadline.reset();
+    res = raptor.compute(sa1, sa2, 7900, 0, DateTimeUtils::inf, type::RTLevel::Base, 2_min, true);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+}
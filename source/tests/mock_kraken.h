@@ -77,7 +77,10 @@ struct mock_kraken {
 
 
         // Launch only one thread for the tests
-        threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf));
+        navitia::kraken::ResponseCache response_cache(conf.response_cache_size(),
+                                                      conf.response_cache_time_bucket());
+        threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf,
+                                        std::string("inproc://workers"), std::ref(response_cache)));
 
         // Connect work threads to client threads via a queue
         do {
@@ -37,6 +37,7 @@ www.navitia.io
 #include "boost/date_time/posix_time/posix_time.hpp"
 #include "utils/paginate.h"
 #include "routing/dataraptor.h"
+#include <boost/dynamic_bitset.hpp>
 
 namespace pt = boost::posix_time;
 
@@ -116,22 +117,19 @@ void departure_board(PbCreator& pb_creator, const std::string& request,
 
     std::map<stop_point_route, vector_dt_st> map_route_stop_point;
 
-    //Mapping route/stop_point
-    std::vector<stop_point_route> sps_routes;
+    //Mapping route/stop_point, the jpps are grouped by the precomputed route points
+    const auto& route_points = pb_creator.data.dataRaptor->route_points;
+    std::vector<size_t> route_point_idxs;
+    boost::dynamic_bitset<> seen_route_points(route_points.size());
     for(auto jpp_idx : handler.journey_pattern_points) {
-        const auto& jpp = pb_creator.data.dataRaptor->jp_container.get(jpp_idx);
-        const auto& jp = pb_creator.data.dataRaptor->jp_container.get(jpp.jp_idx);
-        stop_point_route key = {jpp.sp_idx, jp.route_idx};
-        auto find_predicate = [&](stop_point_route spl) {
-            return spl.first == key.first && spl.second == key.second;
-        };
-        auto it = std::find_if(sps_routes.begin(), sps_routes.end(), find_predicate);
-        if(it == sps_routes.end()){
-            sps_routes.push_back(key);
+        const auto route_point_idx = route_points[jpp_idx];
+        if (! seen_route_points[route_point_idx]) {
+            seen_route_points.set(route_point_idx);
+            route_point_idxs.push_back(route_point_idx);
         }
     }
-    size_t total_result = sps_routes.size();
-    sps_routes = paginate(sps_routes, count, start_page);
+    size_t total_result = route_point_idxs.size();
+    route_point_idxs = paginate(route_point_idxs, count, start_page);
     //Trie des vecteurs de date_times stop_times
     auto sort_predicate = [](routing::datetime_stop_time dt1, routing::datetime_stop_time dt2) {
                     return dt1.first < dt2.first;
@@ -140,29 +138,31 @@ void departure_board(PbCreator& pb_creator, const std::string& request,
     // au meme couple (stop_point, route)
     // On veut en effet afficher les départs regroupés par route
     // (une route étant une vague direction commerciale
-    for(auto sp_route : sps_routes) {
-        std::vector<routing::datetime_stop_time> stop_times;
-        const type::StopPoint* stop_point = pb_creator.data.pt_data->stop_points[sp_route.first.val];
-        const type::Route* route = pb_creator.data.pt_data->routes[sp_route.second.val];
-        const auto& jpps = pb_creator.data.dataRaptor->jpps_from_sp[sp_route.first];
-        std::vector<routing::JppIdx> routepoint_jpps;
-        for (const auto& jpp_from_sp: jpps) {
-            const routing::JppIdx& jpp_idx = jpp_from_sp.idx;
-            const auto& jpp = pb_creator.data.dataRaptor->jp_container.get(jpp_idx);
-            const auto& jp = pb_creator.data.dataRaptor->jp_container.get(jpp.jp_idx);
-            if (jp.route_idx != sp_route.second) { continue; }
-
-            routepoint_jpps.push_back(jpp_idx);
+    std::vector<std::vector<routing::JppIdx>> jpps_by_route_point;
+    for (const auto route_point_idx : route_point_idxs) {
+        jpps_by_route_point.push_back(route_points.get(route_point_idx).jpps);
+    }
+    // the next departures of all the route points are merged in one pass
+    std::vector<vector_dt_st> stop_times_by_route_point;
+    if (! calendar_id) {
+        stop_times_by_route_point = routing::get_stop_times(routing::StopEvent::pick_up, jpps_by_route_point,
+                handler.date_time, handler.max_datetime, items_per_route_point, pb_creator.data, rt_level);
+    } else {
+        for (const auto& routepoint_jpps: jpps_by_route_point) {
+            stop_times_by_route_point.push_back(routing::get_stop_times(routepoint_jpps,
+                    DateTimeUtils::hour(handler.date_time), DateTimeUtils::hour(handler.max_datetime),
+                    pb_creator.data, *calendar_id));
         }
+    }
 
-        std::vector<routing::datetime_stop_time> tmp;
-        if (! calendar_id) {
-            stop_times = routing::get_stop_times(routing::StopEvent::pick_up, routepoint_jpps, handler.date_time,
-                    handler.max_datetime, items_per_route_point, pb_creator.data, rt_level);
-        } else {
-            stop_times = routing::get_stop_times(routepoint_jpps, DateTimeUtils::hour(handler.date_time),
-                    DateTimeUtils::hour(handler.max_datetime), pb_creator.data, *calendar_id);
-        }
+    // the route points without departure nor status, their status is computed afterward
+    std::vector<size_t> without_departure;
+    for (size_t i = 0; i < route_point_idxs.size(); ++i) {
+        const auto& route_point = route_points.get(route_point_idxs[i]);
+        const stop_point_route sp_route = {route_point.sp_idx, route_point.route_idx};
+        auto& stop_times = stop_times_by_route_point[i];
+        const type::StopPoint* stop_point = pb_creator.data.pt_data->stop_points[sp_route.first.val];
+        const type::Route* route = pb_creator.data.pt_data->routes[sp_route.second.val];
         if ( ! calendar_id) {
             std::sort(stop_times.begin(), stop_times.end(), sort_predicate);
         } else {
@@ -174,10 +174,8 @@ void departure_board(PbCreator& pb_creator, const std::string& request,
         }
 
         //we compute the route status
-        for (const auto& jpp_from_sp: jpps) {
-            const routing::JppIdx& jpp_idx = jpp_from_sp.idx;
-            const auto& jpp = pb_creator.data.dataRaptor->jp_container.get(jpp_idx);
-            const auto& jp = pb_creator.data.dataRaptor->jp_container.get(jpp.jp_idx);
+        for (const auto& jpp_from_sp: pb_creator.data.dataRaptor->jpps_from_sp[sp_route.first]) {
+            const auto& jp = pb_creator.data.dataRaptor->jp_container.get(jpp_from_sp.jp_idx);
             const auto& last_jpp = pb_creator.data.dataRaptor->jp_container.get(jp.jpps.back());
             if (sp_route.first == last_jpp.sp_idx) {
                 if (stop_point->stop_area == route->destination) {
@@ -187,24 +185,34 @@ void departure_board(PbCreator& pb_creator, const std::string& request,
                 }
             }
         }
-
-        //If there is no departure for a request with "RealTime", Test existance of any departure with "base_schedule"
-        //If departure with base_schedule is not empty, additional_information = active_disruption
-        //Else additional_information = no_departure_this_day
-        if (stop_times.empty() && (response_status.find(route->idx) == response_status.end())) {
-            auto resp_status = pbnavitia::ResponseStatus::no_departure_this_day;
-            if (rt_level != navitia::type::RTLevel::Base) {
-                auto tmp_stop_times = routing::get_stop_times(routing::StopEvent::pick_up, routepoint_jpps, handler.date_time,
-                                                              handler.max_datetime, 1, pb_creator.data,
-                                                              navitia::type::RTLevel::Base);
-                if (!tmp_stop_times.empty()) { resp_status = pbnavitia::ResponseStatus::active_disruption; }
-            }
-            response_status[route->idx] = resp_status;
+        if (stop_times.empty()) {
+            without_departure.push_back(i);
         }
 
         map_route_stop_point[sp_route] = stop_times;
     }
 
+    //If there is no departure for a request with "RealTime", Test existance of any departure with "base_schedule"
+    //If departure with base_schedule is not empty, additional_information = active_disruption
+    //Else additional_information = no_departure_this_day
+    std::vector<vector_dt_st> base_stop_times(without_departure.size());
+    if (rt_level != navitia::type::RTLevel::Base && ! without_departure.empty()) {
+        std::vector<std::vector<routing::JppIdx>> jpps_without_departure;
+        for (const auto i: without_departure) {
+            jpps_without_departure.push_back(jpps_by_route_point[i]);
+        }
+        base_stop_times = routing::get_stop_times(routing::StopEvent::pick_up, jpps_without_departure,
+                                                  handler.date_time, handler.max_datetime, 1, pb_creator.data,
+                                                  navitia::type::RTLevel::Base);
+    }
+    for (size_t j = 0; j < without_departure.size(); ++j) {
+        const auto route_idx = route_points.get(route_point_idxs[without_departure[j]]).route_idx.val;
+        if (response_status.find(route_idx) != response_status.end()) { continue; }
+        response_status[route_idx] = base_stop_times[j].empty() ?
+                    pbnavitia::ResponseStatus::no_departure_this_day :
+                    pbnavitia::ResponseStatus::active_disruption;
+    }
+
     render(pb_creator, response_status, map_route_stop_point, handler.date_time, handler.max_datetime,
               calendar_id, depth);
 
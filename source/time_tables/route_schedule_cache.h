@@ -0,0 +1,79 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "time_tables/thermometer.h"
+#include "type/bounded_cache.h"
+#include "type/datetime.h"
+#include <boost/functional/hash.hpp>
+#include <memory>
+
+namespace navitia { namespace timetables {
+
+/// The input of the vj ordering of a route schedule
+struct VjOrderKey {
+    type::idx_t route_idx;
+    // for the calendar schedules, the hour from which the vjs are shifted to the next day
+    uint32_t calendar_pivot;
+    // each row of the schedule, the vj and the datetime of its first stop time
+    std::vector<std::pair<type::idx_t, DateTime>> vjs;
+
+    bool operator==(const VjOrderKey& other) const {
+        return route_idx == other.route_idx && calendar_pivot == other.calendar_pivot
+            && vjs == other.vjs;
+    }
+};
+inline size_t hash_value(const VjOrderKey& key) {
+    size_t seed = 0;
+    boost::hash_combine(seed, key.route_idx);
+    boost::hash_combine(seed, key.calendar_pivot);
+    boost::hash_range(seed, key.vjs.begin(), key.vjs.end());
+    return seed;
+}
+
+/** Thermometers and vj orders of the route schedules of a Data
+  *
+  * They only depend on the (immutable) published data, thus, as
+  * ptref::QueryCache, it is owned by the Data it caches.
+  */
+struct RouteScheduleCache {
+    // thermometers of the routes from their journey patterns, by route idx
+    BoundedCache<type::idx_t, std::shared_ptr<const Thermometer>> jp_thermometers;
+    // thermometers of the routes from their vehicle journeys, by route idx
+    BoundedCache<type::idx_t, std::shared_ptr<const Thermometer>> vj_thermometers;
+    // result of the ranked pairs sort of the rows of the schedules
+    BoundedCache<VjOrderKey, std::vector<uint32_t>> vj_orders;
+
+    explicit RouteScheduleCache(size_t max_size):
+        jp_thermometers(max_size), vj_thermometers(max_size), vj_orders(max_size) {}
+};
+
+}} //namespace navitia::timetables
@@ -31,6 +31,7 @@ www.navitia.io
 #include "route_schedules.h"
 #include "routing/dataraptor.h"
 #include "thermometer.h"
+#include "route_schedule_cache.h"
 #include "request_handle.h"
 #include "type/pb_converter.h"
 #include "ptreferential/ptreferential.h"
@@ -293,10 +294,31 @@ std::vector<uint32_t> compute_order(const size_t nb_vertices, const std::vector<
                    << ", nb_topo_sort = " << is_dag.nb_call);
     return std::move(is_dag.order);
 }
-void ranked_pairs_sort(std::vector<std::vector<routing::datetime_stop_time>>& v) {
-    const auto edges = create_edges(v);
-    const auto order = compute_order(v.size(), edges);
-
+// the order of the rows of the schedule, memoized by the data if they have a route_schedule_cache
+std::vector<uint32_t> get_order(std::vector<std::vector<routing::datetime_stop_time>>& v,
+                                const std::vector<std::vector<routing::datetime_stop_time>>& stop_times,
+                                const type::Route& route,
+                                const uint32_t calendar_pivot,
+                                const type::Data& data) {
+    if (! data.route_schedule_cache) {
+        return compute_order(v.size(), create_edges(v));
+    }
+    // the rows only depend on their vj and the datetime of its first stop time
+    VjOrderKey key{route.idx, calendar_pivot, {}};
+    key.vjs.reserve(stop_times.size());
+    for (const auto& vec: stop_times) {
+        key.vjs.emplace_back(vec.front().second->vehicle_journey->idx, vec.front().first);
+    }
+    auto& vj_orders = data.route_schedule_cache->vj_orders;
+    if (auto order = vj_orders.get(key)) {
+        return std::move(*order);
+    }
+    auto order = compute_order(v.size(), create_edges(v));
+    vj_orders.insert(std::move(key), order);
+    return order;
+}
+void ranked_pairs_sort(std::vector<std::vector<routing::datetime_stop_time>>& v,
+                       const std::vector<uint32_t>& order) {
     // reordering v according to the given order
     std::vector<std::vector<routing::datetime_stop_time>> res;
     res.reserve(v.size());
@@ -310,7 +332,9 @@ void ranked_pairs_sort(std::vector<std::vector<routing::datetime_stop_time>>& v)
 static std::vector<std::vector<routing::datetime_stop_time> >
 make_matrice(const std::vector<std::vector<routing::datetime_stop_time> >& stop_times,
              const Thermometer& thermometer,
-             const type::Data&) {
+             const type::Route& route,
+             const uint32_t calendar_pivot,
+             const type::Data& data) {
     // result group stop_times by stop_point, tmp by vj.
     const size_t thermometer_size = thermometer.get_thermometer().size();
     std::vector<std::vector<routing::datetime_stop_time> > 
@@ -329,7 +353,7 @@ make_matrice(const std::vector<std::vector<routing::datetime_stop_time> >& stop_
         ++y;
     }
 
-    ranked_pairs_sort(tmp);
+    ranked_pairs_sort(tmp, get_order(tmp, stop_times, route, calendar_pivot, data));
     // We rotate the matrice, so it can be handle more easily in route_schedule
     for (size_t i=0; i<tmp.size(); ++i) {
         for (size_t j=0; j<tmp[i].size(); ++j) {
@@ -339,6 +363,28 @@ make_matrice(const std::vector<std::vector<routing::datetime_stop_time> >& stop_
     return result;
 }
 
+// the thermometer of the route from its journey patterns, cached by the data if they have a route_schedule_cache
+static std::shared_ptr<const Thermometer> get_jp_thermometer(const type::Route& route, const type::Data& data) {
+    auto& cache = data.route_schedule_cache;
+    if (cache) {
+        if (auto thermometer = cache->jp_thermometers.get(route.idx)) { return *thermometer; }
+    }
+    const auto& jps =  data.dataRaptor->jp_container.get_jps_from_route()[routing::RouteIdx(route)];
+    std::vector<vector_idx> stop_points;
+    for (const auto& jp_idx : jps) {
+        const auto& jp = data.dataRaptor->jp_container.get(jp_idx);
+        stop_points.push_back(vector_idx());
+        for (const auto& jpp_idx : jp.jpps) {
+            const auto& jpp = data.dataRaptor->jp_container.get(jpp_idx);
+            stop_points.back().push_back(jpp.sp_idx.val);
+        }
+    }
+    auto thermometer = std::make_shared<Thermometer>();
+    thermometer->generate_thermometer(stop_points);
+    if (cache) { cache->jp_thermometers.insert(route.idx, thermometer); }
+    return thermometer;
+}
+
 void route_schedule(PbCreator& pb_creator, const std::string& filter,
                const boost::optional<const std::string> calendar_id,
                const std::vector<std::string>& forbidden_uris,
@@ -357,7 +403,6 @@ void route_schedule(PbCreator& pb_creator, const std::string& filter,
     auto pt_max_datetime = to_posix_time(handler.max_datetime, pb_creator.data);
     pb_creator.action_period = pt::time_period(pt_datetime, pt_max_datetime);
 
-    Thermometer thermometer;
     auto routes_idx = ptref::make_query(type::Type_e::Route, filter, forbidden_uris, pb_creator.data);
     size_t total_result = routes_idx.size();
     routes_idx = paginate(routes_idx, count, start_page);
@@ -366,18 +411,10 @@ void route_schedule(PbCreator& pb_creator, const std::string& filter,
         auto stop_times = get_all_route_stop_times(route, handler.date_time,
                                                    handler.max_datetime, max_stop_date_times,
                                                    pb_creator.data, rt_level, calendar_id);
-        const auto& jps =  pb_creator.data.dataRaptor->jp_container.get_jps_from_route()[routing::RouteIdx(*route)];
-        std::vector<vector_idx> stop_points;
-        for (const auto& jp_idx : jps) {
-            const auto& jp = pb_creator.data.dataRaptor->jp_container.get(jp_idx);
-            stop_points.push_back(vector_idx());
-            for (const auto& jpp_idx : jp.jpps) {
-                const auto& jpp = pb_creator.data.dataRaptor->jp_container.get(jpp_idx);
-                stop_points.back().push_back(jpp.sp_idx.val);
-            }
-        }
-        thermometer.generate_thermometer(stop_points);
-        auto  matrice = make_matrice(stop_times, thermometer, pb_creator.data);
+        const auto thermometer_ptr = get_jp_thermometer(*route, pb_creator.data);
+        const auto& thermometer = *thermometer_ptr;
+        const uint32_t calendar_pivot = calendar_id ? DateTimeUtils::hour(handler.date_time) : 0;
+        auto  matrice = make_matrice(stop_times, thermometer, *route, calendar_pivot, pb_creator.data);
 
         auto schedule = pb_creator.add_route_schedules();
         pbnavitia::Table *table = schedule->mutable_table();
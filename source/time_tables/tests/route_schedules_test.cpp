@@ -35,6 +35,7 @@ www.navitia.io
 #include "type/type.h"
 #include "tests/utils_test.h"
 #include "time_tables/route_schedules.h"
+#include "time_tables/route_schedule_cache.h"
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/range/algorithm/sort.hpp>
 #include "kraken/apply_disruption.h"
@@ -151,6 +152,31 @@ BOOST_FIXTURE_TEST_CASE(test_max_nb_stop_times, route_schedule_fixture) {
     BOOST_REQUIRE_EQUAL(route_schedule.table().headers().size(), 0);
 }
 
+BOOST_FIXTURE_TEST_CASE(test_route_schedule_cache, route_schedule_fixture) {
+    b.data->enable_route_schedule_cache();
+    const auto& cache = *b.data->route_schedule_cache;
+
+    for (int i = 0; i < 2; ++i) {
+        navitia::PbCreator pb_creator(*b.data, bt::second_clock::universal_time(), null_time_period);
+        navitia::timetables::route_schedule(pb_creator, "line.uri=A", {}, {}, d("20120615T070000"), 86400, 100,
+                                                                       3, 10, 0, nt::RTLevel::Base);
+        pbnavitia::Response resp = pb_creator.get_response();
+        BOOST_REQUIRE_EQUAL(resp.route_schedules().size(), 1);
+        pbnavitia::RouteSchedule route_schedule = resp.route_schedules(0);
+        BOOST_REQUIRE_EQUAL(get_vj(route_schedule, 0), "2");
+        BOOST_REQUIRE_EQUAL(get_vj(route_schedule, 1), "1");
+        BOOST_REQUIRE_EQUAL(get_vj(route_schedule, 2), "3");
+        BOOST_REQUIRE_EQUAL(get_vj(route_schedule, 3), "4");
+    }
+    // the second schedule has been computed from the cache
+    BOOST_CHECK_EQUAL(cache.jp_thermometers.size(), 1);
+    BOOST_CHECK_EQUAL(cache.jp_thermometers.get_nb_calls(), 2);
+    BOOST_CHECK_EQUAL(cache.jp_thermometers.get_nb_cache_miss(), 1);
+    BOOST_CHECK_EQUAL(cache.vj_orders.size(), 1);
+    BOOST_CHECK_EQUAL(cache.vj_orders.get_nb_calls(), 2);
+    BOOST_CHECK_EQUAL(cache.vj_orders.get_nb_cache_miss(), 1);
+}
+
 /*
 We have 3 vehicle journeys VJ5, VJ6, VJ7 and 3 stops S1, S2, S3 :
      VJ5     VJ6     VJ7
@@ -29,6 +29,7 @@ www.navitia.io
 */
 
 #include "thermometer.h"
+#include "route_schedule_cache.h"
 #include "ptreferential/ptreferential.h"
 #include "time.h"
 #include <boost/graph/adjacency_list.hpp>
@@ -121,6 +122,17 @@ static uint32_t get_max_sp(const std::vector<vector_idx>& journey_patterns) {
     return max_sp;
 }
 
+std::shared_ptr<const Thermometer> get_thermometer(const type::Route* route, const type::Data& data) {
+    auto& cache = data.route_schedule_cache;
+    if (cache) {
+        if (auto thermometer = cache->vj_thermometers.get(route->idx)) { return *thermometer; }
+    }
+    auto thermometer = std::make_shared<Thermometer>();
+    thermometer->generate_thermometer(route);
+    if (cache) { cache->vj_thermometers.insert(route->idx, thermometer); }
+    return thermometer;
+}
+
 void Thermometer::generate_thermometer(const type::Route* route) {
     std::set<vector_idx> stop_point_lists;
     route->for_each_vehicle_journey([&](const type::VehicleJourney& vj) {
@@ -225,7 +237,7 @@ void Thermometer::generate_thermometer(const std::vector<vector_idx> &sps) {
 }
 
 
-vector_idx Thermometer::get_thermometer() const {
+const vector_idx& Thermometer::get_thermometer() const {
     return thermometer;
 }
 
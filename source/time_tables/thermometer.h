@@ -31,6 +31,7 @@ www.navitia.io
 #pragma once
 #include "type/data.h"
 #include "boost/functional/hash.hpp"
+#include <memory>
 namespace navitia { namespace timetables {
 
 typedef std::vector<idx_t> vector_idx;
@@ -39,7 +40,7 @@ typedef std::vector<uint16_t> vector_size;
 struct Thermometer {
     void generate_thermometer(const std::vector<vector_idx> &journey_patterns);
     void generate_thermometer(const type::Route* route);
-    vector_idx get_thermometer() const;
+    const vector_idx& get_thermometer() const;
 
     // res[stop_time.order()] correspond to the index of the
     // thermometer for a stop time of the given vj
@@ -69,6 +70,9 @@ private :
 };
 uint32_t get_lower_bound(std::vector<vector_size> &pre_computed_lb, vector_size mins, type::idx_t max_sp);
 
+/// The thermometer of the route from its vehicle journeys, cached by the data if they have a route_schedule_cache
+std::shared_ptr<const Thermometer> get_thermometer(const type::Route* route, const type::Data& data);
+
 
 
 }}
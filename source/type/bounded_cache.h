@@ -0,0 +1,112 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace navitia {
+
+/// Each element weights 1: the cache is bounded by its number of elements
+struct UnitWeight {
+    template<typename T> size_t operator()(const T&) const { return 1; }
+};
+
+/** Thread safe bounded cache, the least recently used elements are dropped when full
+  *
+  * The cache is full when the sum of the Weight of its elements would exceed
+  * max_weight, an element heavier than max_weight is not kept.
+  *
+  * Unlike utils/lru.h, the values are computed by the caller outside of the
+  * lock: 2 threads can compute the same value, but a long computation does
+  * not block the other ones.
+  */
+template<typename Key, typename Value, typename Hash = boost::hash<Key>, typename Weight = UnitWeight>
+class BoundedCache {
+    typedef std::list<std::pair<Key, Value>> List;
+    size_t max_weight;
+    size_t weight = 0;
+    List elements; // most recently used first
+    std::unordered_map<Key, typename List::iterator, Hash> map;
+    mutable std::mutex mutex;
+    size_t nb_calls = 0;
+    size_t nb_cache_miss = 0;
+
+public:
+    explicit BoundedCache(size_t max_weight): max_weight(max_weight) {}
+
+    boost::optional<Value> get(const Key& key) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++nb_calls;
+        const auto it = map.find(key);
+        if (it == map.end()) {
+            ++nb_cache_miss;
+            return boost::none;
+        }
+        elements.splice(elements.begin(), elements, it->second);
+        return it->second->second;
+    }
+
+    void insert(const Key& key, Value value) {
+        const size_t value_weight = Weight()(value);
+        if (value_weight > max_weight) { return; }
+        std::lock_guard<std::mutex> lock(mutex);
+        if (map.count(key)) { return; } // another thread has been quicker
+        elements.emplace_front(key, std::move(value));
+        map[key] = elements.begin();
+        weight += value_weight;
+        while (weight > max_weight) {
+            weight -= Weight()(elements.back().second);
+            map.erase(elements.back().first);
+            elements.pop_back();
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        map.clear();
+        elements.clear();
+        weight = 0;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return elements.size();
+    }
+    size_t get_weight() const { std::lock_guard<std::mutex> lock(mutex); return weight; }
+    size_t get_nb_calls() const { std::lock_guard<std::mutex> lock(mutex); return nb_calls; }
+    size_t get_nb_cache_miss() const { std::lock_guard<std::mutex> lock(mutex); return nb_cache_miss; }
+};
+
+} //namespace navitia
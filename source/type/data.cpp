@@ -34,6 +34,8 @@ www.navitia.io
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
@@ -42,7 +44,14 @@ www.navitia.io
 #include <boost/serialization/variant.hpp>
 #include <boost/range/algorithm/find.hpp>
 #include <boost/container/container_fwd.hpp>
+#include <boost/dynamic_bitset.hpp>
 #include <thread>
+#include <functional>
+#include <cstring>
+#include <memory>
+#include <exception>
+#include <sstream>
+#include <unordered_map>
 
 #include "third_party/eos_portable_archive/portable_iarchive.hpp"
 #include "third_party/eos_portable_archive/portable_oarchive.hpp"
@@ -56,15 +65,163 @@ www.navitia.io
 #include "georef/georef.h"
 #include "fare/fare.h"
 #include "type/meta_data.h"
+#include "type/task_graph.h"
 #include "kraken/fill_disruption_from_database.h"
+#include "ptreferential/query_cache.h"
+#include "time_tables/route_schedule_cache.h"
 
 namespace pt = boost::posix_time;
 
 namespace navitia { namespace type {
 
+/*
+ * Sectioned data file:
+ *
+ *   magic (8 bytes) | data_version (uint32) | nb_sections (uint32)
+ *   nb_sections * [offset (uint64) | size (uint64)]   (offsets from the begining of the file)
+ *   sections, each one being a lz4 frame compressed portable archive, but the last one
+ *
+ * The sections are in the Section order, aligned on 64 bytes. Integers are
+ * little endian, like in the lz4 frames.
+ *
+ * The last section holds the flat arrays, used in place when the file is
+ * memory mapped:
+ *
+ *   byte_order (uint32, 0x01020304 in the byte order of the writer) | nb_arrays (uint32)
+ *   nb_arrays * [offset (uint64) | nb_elements (uint64) | element_size (uint64)]
+ *   (offsets from the begining of the section)
+ *   arrays, in the FlatArrayId order, in the memory layout of the writer, aligned on 64 bytes
+ *
+ * A reader with another layout rebuilds them from the other sections.
+ */
+static const char sections_magic[8] = {'N', 'A', 'V', 'S', 'E', 'C', 'T', '1'};
+enum class Section : uint32_t { Meta = 0, PtData, GeoRef, Fare, CrossReferences, Raptor, FlatArrays, Count };
+enum class FlatArrayId : uint32_t { StopAreaProximity = 0, StopPointProximity, PoiProximity, VertexProximity, Count };
+static const uint64_t section_alignment = 64;
+static const uint32_t byte_order_mark = 0x01020304;
+
+static uint64_t align_section(uint64_t offset) {
+    return (offset + section_alignment - 1) / section_alignment * section_alignment;
+}
+
+static bool is_sectioned(const char* begin, size_t size) {
+    return size >= sizeof(sections_magic) && std::equal(sections_magic, sections_magic + sizeof(sections_magic), begin);
+}
+
+static bool is_lz4_frame(const char* begin, size_t size) {
+    return size >= 4 && lz4_frame::read_le32(begin) == lz4_frame::magic_number;
+}
+
+static uint64_t read_le64(const char* src) {
+    return uint64_t(lz4_frame::read_le32(src)) | (uint64_t(lz4_frame::read_le32(src + 4)) << 32);
+}
+
+static void write_le64(std::string& dest, uint64_t value) {
+    lz4_frame::write_le32(dest, uint32_t(value & 0xFFFFFFFF));
+    lz4_frame::write_le32(dest, uint32_t(value >> 32));
+}
+
+// a flat array of the data file
+struct FlatChunk {
+    const char* data;
+    uint64_t nb_elements;
+    uint64_t element_size;
+};
+
+template<typename T>
+static FlatChunk make_flat_chunk(const FlatArray<T>& array) {
+    return {reinterpret_cast<const char*>(array.begin()), array.size(), sizeof(T)};
+}
+
+static std::string save_flat_arrays(const std::vector<FlatChunk>& chunks) {
+    std::string res(sizeof(byte_order_mark), '\0');
+    std::memcpy(&res[0], &byte_order_mark, sizeof(byte_order_mark));
+    lz4_frame::write_le32(res, uint32_t(chunks.size()));
+    uint64_t offset = res.size() + chunks.size() * 3 * sizeof(uint64_t);
+    std::vector<uint64_t> offsets;
+    for (const auto& chunk: chunks) {
+        offset = align_section(offset);
+        offsets.push_back(offset);
+        write_le64(res, offset);
+        write_le64(res, chunk.nb_elements);
+        write_le64(res, chunk.element_size);
+        offset += chunk.nb_elements * chunk.element_size;
+    }
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        res.resize(offsets[i], '\0');
+        res.append(chunks[i].data, chunks[i].nb_elements * chunks[i].element_size);
+    }
+    return res;
+}
+
+// the chunks of the flat arrays section, empty if they have not the memory layout of this host
+static std::vector<FlatChunk> read_flat_arrays(const char* begin, uint64_t size) {
+    if (size < 2 * sizeof(uint32_t)) {
+        throw navitia::exception("truncated flat arrays section");
+    }
+    uint32_t byte_order = 0;
+    std::memcpy(&byte_order, begin, sizeof(byte_order));
+    const uint32_t nb_arrays = lz4_frame::read_le32(begin + sizeof(byte_order));
+    if (nb_arrays != uint32_t(FlatArrayId::Count)) {
+        throw navitia::exception("unexpected number of flat arrays in the data file");
+    }
+    if (size < 2 * sizeof(uint32_t) + nb_arrays * 3 * sizeof(uint64_t)) {
+        throw navitia::exception("truncated flat arrays section");
+    }
+    std::vector<FlatChunk> chunks;
+    const char* cursor = begin + 2 * sizeof(uint32_t);
+    for (uint32_t i = 0; i < nb_arrays; ++i, cursor += 3 * sizeof(uint64_t)) {
+        const uint64_t offset = read_le64(cursor);
+        const uint64_t nb_elements = read_le64(cursor + sizeof(uint64_t));
+        const uint64_t element_size = read_le64(cursor + 2 * sizeof(uint64_t));
+        if (offset > size || (element_size && nb_elements > (size - offset) / element_size)) {
+            throw navitia::exception("truncated data file, a flat array is out of its section");
+        }
+        chunks.push_back({begin + offset, nb_elements, element_size});
+    }
+    if (byte_order != byte_order_mark) { return {}; }
+    return chunks;
+}
+
+/*
+ * Uses the chunk in place when the mapping can be kept alive and the
+ * elements are aligned, copies it otherwise.
+ * false if the chunk has not the memory layout of the array
+ */
+template<typename T>
+static bool load_flat_array(FlatArray<T>& array, const FlatChunk& chunk,
+                            const std::shared_ptr<const void>& keep_alive) {
+    if (chunk.element_size != sizeof(T)) { return false; }
+    if (keep_alive && reinterpret_cast<uintptr_t>(chunk.data) % alignof(T) == 0) {
+        array.map(reinterpret_cast<const T*>(chunk.data), chunk.nb_elements, keep_alive);
+    } else {
+        array.copy(chunk.data, chunk.nb_elements);
+    }
+    return true;
+}
+
+// run all the functions in parallel, the first exception is thrown once they are all finished
+static void run_in_parallel(const std::vector<std::function<void()>>& functions) {
+    std::vector<std::exception_ptr> errors(functions.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < functions.size(); ++i) {
+        threads.emplace_back([&, i]() {
+            try {
+                functions[i]();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread: threads) { thread.join(); }
+    for (const auto& error: errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+}
+
 wrong_version::~wrong_version() noexcept {}
 
-const unsigned int Data::data_version = 58; //< *INCREMENT* every time serialized data are modified
+const unsigned int Data::data_version = 61; //< *INCREMENT* every time serialized data are modified
 
 Data::Data(size_t data_identifier) :
     data_identifier(data_identifier),
@@ -73,6 +230,8 @@ Data::Data(size_t data_identifier) :
     geo_ref(std::make_unique<navitia::georef::GeoRef>()),
     dataRaptor(std::make_unique<navitia::routing::dataRAPTOR>()),
     fare(std::make_unique<navitia::fare::Fare>()),
+    relation_index(std::make_unique<RelationIndex>()),
+    temporal_index(std::make_unique<TemporalIndex>()),
     find_admins(
             [&](const GeographicalCoord &c){
             return geo_ref->find_admins(c);
@@ -85,15 +244,24 @@ Data::Data(size_t data_identifier) :
 
 Data::~Data(){}
 
+void Data::enable_ptref_cache(size_t max_nb_indexes) const {
+    ptref_cache = std::make_unique<navitia::ptref::QueryCache>(max_nb_indexes);
+}
+
+void Data::enable_route_schedule_cache(size_t max_size) const {
+    route_schedule_cache = std::make_unique<navitia::timetables::RouteScheduleCache>(max_size);
+}
+
 bool Data::load(const std::string& filename,
         const boost::optional<std::string>& chaos_database,
         const std::vector<std::string>& contributors) {
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     loading = true;
     try {
-        std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
-        ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        this->load(ifs);
+        // the sections of the file are read concurrently from a read only
+        // mapping, kept as long as its flat arrays are used in place
+        const auto file = std::make_shared<boost::iostreams::mapped_file_source>(filename);
+        this->load(file->data(), file->size(), file);
         last_load_at = pt::microsec_clock::universal_time();
         last_load = true;
         loaded = true;
@@ -122,12 +290,238 @@ bool Data::load(const std::string& filename,
 
 void Data::load(std::istream& ifs) {
     boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-    in.push(LZ4Decompressor(2048*500),8192*500, 8192*500);
+    in.push(LZ4FrameDecompressor());
     in.push(ifs);
     eos::portable_iarchive ia(in);
     ia >> *this;
 }
 
+void Data::load(const char* begin, size_t size, const std::shared_ptr<const void>& keep_alive) {
+    if (is_sectioned(begin, size)) {
+        load_sections(begin, size, keep_alive);
+        return;
+    }
+    boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+    if (is_lz4_frame(begin, size)) {
+        in.push(LZ4FrameDecompressor());
+    } else {
+        // the old format, only to be able to read its version and say it's too old
+        in.push(LZ4Decompressor(2048*500),8192*500, 8192*500);
+    }
+    in.push(boost::iostreams::array_source(begin, size));
+    eos::portable_iarchive ia(in);
+    ia >> *this;
+}
+
+template<class Archive> void Data::serialize_proximity_lists(Archive& ar) const {
+    ar & pt_data->stop_area_proximity_list & pt_data->stop_point_proximity_list
+       & geo_ref->poi_proximity_list & geo_ref->pl;
+}
+
+void Data::check_version(unsigned int version) {
+    this->version = version;
+    if(this->version != data_version){
+        unsigned int v = data_version;//sinon ca link pas...
+        auto msg = boost::format("Warning data version don't match with the data version of kraken %u (current version: %d)") % version % v;
+        throw wrong_version(msg.str());
+    }
+}
+
+void Data::CrossReferences::build(const Data& data) {
+    std::unordered_map<const georef::Admin*, idx_t> admin_positions;
+    for (idx_t pos = 0; pos < data.geo_ref->admins.size(); ++pos) {
+        admin_positions[data.geo_ref->admins[pos]] = pos;
+    }
+    auto admin_indexes = [&](const std::vector<georef::Admin*>& admins) {
+        std::vector<idx_t> res;
+        for (const auto* admin: admins) {
+            const auto it = admin_positions.find(admin);
+            if (it != admin_positions.end()) { res.push_back(it->second); }
+        }
+        return res;
+    };
+    for (const auto* sp: data.pt_data->stop_points) {
+        stop_point_admins.push_back(admin_indexes(sp->admin_list));
+    }
+    for (const auto* sa: data.pt_data->stop_areas) {
+        stop_area_admins.push_back(admin_indexes(sa->admin_list));
+    }
+    for (const auto* admin: data.geo_ref->admins) {
+        admin_main_stop_areas.emplace_back();
+        for (const auto* sa: admin->main_stop_areas) { admin_main_stop_areas.back().push_back(sa->idx); }
+        admin_odt_stop_points.emplace_back();
+        for (const auto* sp: admin->odt_stop_points) { admin_odt_stop_points.back().push_back(sp->idx); }
+    }
+}
+
+void Data::CrossReferences::apply(Data& data) const {
+    const auto& admins = data.geo_ref->admins;
+    const auto& stop_points = data.pt_data->stop_points;
+    const auto& stop_areas = data.pt_data->stop_areas;
+    if (stop_point_admins.size() != stop_points.size() || stop_area_admins.size() != stop_areas.size()
+            || admin_main_stop_areas.size() != admins.size()
+            || admin_odt_stop_points.size() != admins.size()) {
+        throw navitia::exception("inconsistent links between the pt data and the georef");
+    }
+    for (size_t pos = 0; pos < stop_points.size(); ++pos) {
+        stop_points[pos]->admin_list.clear();
+        for (const idx_t idx: stop_point_admins[pos]) { stop_points[pos]->admin_list.push_back(admins.at(idx)); }
+    }
+    for (size_t pos = 0; pos < stop_areas.size(); ++pos) {
+        stop_areas[pos]->admin_list.clear();
+        for (const idx_t idx: stop_area_admins[pos]) { stop_areas[pos]->admin_list.push_back(admins.at(idx)); }
+    }
+    for (size_t pos = 0; pos < admins.size(); ++pos) {
+        admins[pos]->main_stop_areas.clear();
+        for (const idx_t idx: admin_main_stop_areas[pos]) {
+            admins[pos]->main_stop_areas.push_back(stop_areas.at(idx));
+        }
+        admins[pos]->odt_stop_points.clear();
+        for (const idx_t idx: admin_odt_stop_points[pos]) {
+            admins[pos]->odt_stop_points.push_back(stop_points.at(idx));
+        }
+    }
+}
+
+void Data::save_sections(std::ostream& ofs) const {
+    CrossReferences cross_references;
+    cross_references.build(*this);
+
+    const size_t nb_sections = size_t(Section::Count);
+    std::vector<std::string> sections(nb_sections);
+    auto compress = [&](Section section, std::function<void(eos::portable_oarchive&)> save_section) {
+        return [&sections, section, save_section]() {
+            std::ostringstream oss;
+            {
+                boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
+                out.push(LZ4FrameCompressor());
+                out.push(oss);
+                eos::portable_oarchive oa(out);
+                save_section(oa);
+            }
+            sections[size_t(section)] = oss.str();
+        };
+    };
+    run_in_parallel({
+        compress(Section::Meta, [&](eos::portable_oarchive& oa) {
+            oa << *meta << last_load_at << loaded << last_load << is_connected_to_rabbitmq << is_realtime_loaded;
+        }),
+        compress(Section::PtData, [&](eos::portable_oarchive& oa) { oa << *pt_data; }),
+        compress(Section::GeoRef, [&](eos::portable_oarchive& oa) { oa << *geo_ref; }),
+        compress(Section::Fare, [&](eos::portable_oarchive& oa) { oa << *fare; }),
+        compress(Section::CrossReferences, [&](eos::portable_oarchive& oa) { oa << cross_references; }),
+        compress(Section::Raptor, [&](eos::portable_oarchive& oa) {
+            // an empty PersistedRaptor (version 0) if dataRaptor has not been built
+            const auto persisted = dataRaptor->cached_next_st_manager
+                ? dataRaptor->make_persisted(*pt_data)
+                : navitia::routing::PersistedRaptor();
+            oa << persisted;
+        }),
+        [&]() {
+            std::vector<FlatChunk> chunks(size_t(FlatArrayId::Count));
+            chunks[size_t(FlatArrayId::StopAreaProximity)] = make_flat_chunk(pt_data->stop_area_proximity_list.items);
+            chunks[size_t(FlatArrayId::StopPointProximity)] = make_flat_chunk(pt_data->stop_point_proximity_list.items);
+            chunks[size_t(FlatArrayId::PoiProximity)] = make_flat_chunk(geo_ref->poi_proximity_list.items);
+            chunks[size_t(FlatArrayId::VertexProximity)] = make_flat_chunk(geo_ref->pl.items);
+            sections[size_t(Section::FlatArrays)] = save_flat_arrays(chunks);
+        },
+    });
+
+    std::string header(sections_magic, sizeof(sections_magic));
+    lz4_frame::write_le32(header, data_version);
+    lz4_frame::write_le32(header, uint32_t(nb_sections));
+    uint64_t offset = header.size() + nb_sections * 2 * sizeof(uint64_t);
+    std::vector<uint64_t> offsets;
+    for (const auto& section: sections) {
+        offset = align_section(offset);
+        offsets.push_back(offset);
+        write_le64(header, offset);
+        write_le64(header, section.size());
+        offset += section.size();
+    }
+    ofs.write(header.data(), header.size());
+    uint64_t written = header.size();
+    for (size_t i = 0; i < nb_sections; ++i) {
+        const std::string padding(offsets[i] - written, '\0');
+        ofs.write(padding.data(), padding.size());
+        ofs.write(sections[i].data(), sections[i].size());
+        written = offsets[i] + sections[i].size();
+    }
+}
+
+void Data::load_sections(const char* begin, size_t size, const std::shared_ptr<const void>& keep_alive) {
+    const char* cursor = begin + sizeof(sections_magic);
+    // returns the next nb_bytes of the header
+    auto read_header = [&](size_t nb_bytes) {
+        if (cursor + nb_bytes > begin + size) {
+            throw navitia::exception("truncated data file header");
+        }
+        const char* res = cursor;
+        cursor += nb_bytes;
+        return res;
+    };
+    const uint32_t file_version = lz4_frame::read_le32(read_header(sizeof(uint32_t)));
+    check_version(file_version);
+    const uint32_t nb_sections = lz4_frame::read_le32(read_header(sizeof(uint32_t)));
+    if (nb_sections != uint32_t(Section::Count)) {
+        throw navitia::exception("unexpected number of sections in the data file");
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> offsets(nb_sections);
+    for (auto& offset: offsets) {
+        offset.first = read_le64(read_header(sizeof(uint64_t)));
+        offset.second = read_le64(read_header(sizeof(uint64_t)));
+        if (offset.first + offset.second > size) {
+            throw navitia::exception("truncated data file, a section is out of the file");
+        }
+    }
+
+    CrossReferences cross_references;
+    auto decompress = [&](Section section, std::function<void(eos::portable_iarchive&)> load_section) {
+        return [&offsets, begin, section, load_section]() {
+            const auto& offset = offsets[size_t(section)];
+            boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+            in.push(LZ4FrameDecompressor());
+            in.push(boost::iostreams::array_source(begin + offset.first, offset.second));
+            eos::portable_iarchive ia(in);
+            load_section(ia);
+        };
+    };
+    // the flat arrays section is not compressed, it is read once the others have landed
+    run_in_parallel({
+        decompress(Section::Meta, [&](eos::portable_iarchive& ia) {
+            ia >> *meta >> last_load_at >> loaded >> last_load >> is_connected_to_rabbitmq >> is_realtime_loaded;
+        }),
+        decompress(Section::PtData, [&](eos::portable_iarchive& ia) { ia >> *pt_data; }),
+        decompress(Section::GeoRef, [&](eos::portable_iarchive& ia) { ia >> *geo_ref; }),
+        decompress(Section::Fare, [&](eos::portable_iarchive& ia) { ia >> *fare; }),
+        decompress(Section::CrossReferences, [&](eos::portable_iarchive& ia) { ia >> cross_references; }),
+        decompress(Section::Raptor, [&](eos::portable_iarchive& ia) {
+            auto persisted = std::make_unique<navitia::routing::PersistedRaptor>();
+            ia >> *persisted;
+            if (persisted->version != 0) { persisted_raptor = std::move(persisted); }
+        }),
+    });
+    // all the sections have landed, we can link them
+    cross_references.apply(*this);
+
+    const auto& flat_offset = offsets[size_t(Section::FlatArrays)];
+    const auto chunks = read_flat_arrays(begin + flat_offset.first, flat_offset.second);
+    const bool same_layout = ! chunks.empty()
+        && load_flat_array(pt_data->stop_area_proximity_list.items,
+                           chunks[size_t(FlatArrayId::StopAreaProximity)], keep_alive)
+        && load_flat_array(pt_data->stop_point_proximity_list.items,
+                           chunks[size_t(FlatArrayId::StopPointProximity)], keep_alive)
+        && load_flat_array(geo_ref->poi_proximity_list.items,
+                           chunks[size_t(FlatArrayId::PoiProximity)], keep_alive)
+        && load_flat_array(geo_ref->pl.items, chunks[size_t(FlatArrayId::VertexProximity)], keep_alive);
+    if (! same_layout) {
+        LOG4CPLUS_WARN(log4cplus::Logger::getInstance("log"),
+                       "the flat arrays of the data file have another memory layout, they are rebuilt");
+        pt_data->build_proximity_list();
+        geo_ref->build_proximity_list();
+    }
+}
+
 
 void Data::save(const std::string& filename) const {
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
@@ -147,7 +541,7 @@ void Data::save(const std::string& filename) const {
     std::ofstream ofs(filename.c_str(),std::ios::out|std::ios::binary|std::ios::trunc);
     ofs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     try{
-        this->save(ofs);
+        this->save_sections(ofs);
     } catch(const boost::filesystem::filesystem_error &e) {
         if(e.code() == boost::system::errc::permission_denied)
             LOG4CPLUS_ERROR(logger, "Writing permission is denied for " << p);
@@ -172,7 +566,7 @@ void Data::save(const std::string& filename) const {
 
 void Data::save(std::ostream& ofs) const {
     boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
-    out.push(LZ4Compressor(2048*500), 1024*500, 1024*500);
+    out.push(LZ4FrameCompressor());
     out.push(ofs);
     eos::portable_oarchive oa(out);
     oa << *this;
@@ -249,11 +643,74 @@ void Data::build_autocomplete(){
 }
 
 void Data::build_raptor(size_t cache_size) {
-    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("log"),
-                    "Start to build dataRaptor");
-    dataRaptor->load(*this->pt_data, cache_size);
-    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("log"),
-                    "Finished to build dataRaptor");
+    TaskGraph graph;
+    graph.add("dataRaptor", {"pt_data"}, {"raptor"}, [&]() {
+        // the persisted dataRaptor is used only if its vjs still match pt_data,
+        // the vjs added by the disruptions applied at load are grouped on top of it
+        if (persisted_raptor && dataRaptor->load(*this->pt_data, *persisted_raptor, cache_size)) {
+            LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("log"),
+                            "dataRaptor loaded from the data file");
+        } else {
+            dataRaptor->load(*this->pt_data, cache_size);
+        }
+        persisted_raptor.reset();
+    });
+    // the journey patterns have been rebuilt, the relations must follow
+    graph.add("relation index", {"pt_data", "raptor"}, {"relation_index"}, [&]() { build_relation_index(); });
+    graph.add("temporal index", {"pt_data"}, {"temporal_index"}, [&]() { build_temporal_index(); });
+    graph.add("impact index", {"pt_data", "raptor"}, {"impact_index"}, [&]() { build_impact_index(); });
+    log_reports("dataRaptor build:", graph.run());
+}
+
+void Data::build_temporal_index() {
+    auto logger = log4cplus::Logger::getInstance("log");
+    LOG4CPLUS_DEBUG(logger, "Start to build the temporal index");
+    temporal_index->build(*pt_data);
+    LOG4CPLUS_DEBUG(logger, "Finished to build the temporal index");
+}
+
+void Data::build_impact_index() {
+    auto logger = log4cplus::Logger::getInstance("log");
+    LOG4CPLUS_DEBUG(logger, "Start to build the impact index");
+    // the networks of the journey patterns stopping at each stop point
+    std::vector<std::vector<idx_t>> networks_by_stop_point(pt_data->stop_points.size());
+    for (const auto sp_jpps: dataRaptor->jpps_from_sp) {
+        auto& networks = networks_by_stop_point[sp_jpps.first.val];
+        for (const auto& jpp: sp_jpps.second) {
+            const auto& jp = dataRaptor->jp_container.get(jpp.jp_idx);
+            const auto* line = pt_data->routes[jp.route_idx.val]->line;
+            if (line && line->network) { networks.push_back(line->network->idx); }
+        }
+        std::sort(networks.begin(), networks.end());
+        networks.erase(std::unique(networks.begin(), networks.end()), networks.end());
+    }
+    pt_data->impact_index.build(*pt_data, meta->production_date, std::move(networks_by_stop_point));
+    LOG4CPLUS_DEBUG(logger, "Finished to build the impact index");
+}
+
+void Data::build_relation_index() {
+    // the most used joins of ptref, in both directions when it makes sense.
+    // The impacts, connections and pois are not materialized, they are
+    // either rarely used or mutated without rebuilding raptor.
+    static const std::vector<std::pair<Type_e, Type_e>> pairs = {
+        {Type_e::Network, Type_e::Line}, {Type_e::Line, Type_e::Network},
+        {Type_e::Company, Type_e::Line}, {Type_e::Line, Type_e::Company},
+        {Type_e::CommercialMode, Type_e::Line}, {Type_e::Line, Type_e::CommercialMode},
+        {Type_e::Line, Type_e::Route}, {Type_e::Route, Type_e::Line},
+        {Type_e::Route, Type_e::JourneyPattern}, {Type_e::JourneyPattern, Type_e::Route},
+        {Type_e::Route, Type_e::VehicleJourney}, {Type_e::VehicleJourney, Type_e::Route},
+        {Type_e::JourneyPattern, Type_e::VehicleJourney}, {Type_e::VehicleJourney, Type_e::JourneyPattern},
+        {Type_e::JourneyPattern, Type_e::JourneyPatternPoint},
+        {Type_e::JourneyPatternPoint, Type_e::JourneyPattern},
+        {Type_e::JourneyPatternPoint, Type_e::StopPoint}, {Type_e::StopPoint, Type_e::JourneyPatternPoint},
+        {Type_e::StopArea, Type_e::StopPoint}, {Type_e::StopPoint, Type_e::StopArea},
+        {Type_e::VehicleJourney, Type_e::PhysicalMode}, {Type_e::PhysicalMode, Type_e::VehicleJourney},
+        {Type_e::VehicleJourney, Type_e::Company},
+    };
+    auto logger = log4cplus::Logger::getInstance("log");
+    LOG4CPLUS_DEBUG(logger, "Start to build the relation index");
+    relation_index->build(*this, pairs);
+    LOG4CPLUS_DEBUG(logger, "Finished to build the relation index");
 }
 
 ValidityPattern* Data::get_similar_validity_pattern(ValidityPattern* vp) const{
@@ -304,40 +761,28 @@ find_matching_calendar(const Data&, const std::string& name, const ValidityPatte
 }
 
 void Data::complete(){
-    auto logger = log4cplus::Logger::getInstance("log");
-    pt::ptime start;
-    int admin, sort, autocomplete;
-
-    build_grid_validity_pattern();
-    //build_associated_calendar(); read from database
-    
-    start = pt::microsec_clock::local_time();
-    LOG4CPLUS_INFO(logger, "Building administrative regions");
-    build_administrative_regions();
-    admin = (pt::microsec_clock::local_time() - start).total_milliseconds();
-
-    aggregate_odt();
-
-    build_relations();
-
-    compute_labels();
-
-    start = pt::microsec_clock::local_time();
-    pt_data->sort();
-    sort = (pt::microsec_clock::local_time() - start).total_milliseconds();
-
-    start = pt::microsec_clock::local_time();
-    LOG4CPLUS_INFO(logger, "Building proximity list");
-    build_proximity_list();
-    LOG4CPLUS_INFO(logger, "Building uri maps");
-    build_uri();
-    LOG4CPLUS_INFO(logger, "Building autocomplete");
-    build_autocomplete();
-    autocomplete = (pt::microsec_clock::local_time() - start).total_milliseconds();
-
-    LOG4CPLUS_INFO(logger, "\t Building admins: " << admin << "ms");
-    LOG4CPLUS_INFO(logger, "\t Sorting data: " << sort << "ms");
-    LOG4CPLUS_INFO(logger, "\t Building autocomplete " << autocomplete << "ms");
+    // The steps are run in parallel when they do not touch the same data.
+    // All the steps iterating on the pt_data collections read "pt_order",
+    // which is modified by the sort.
+    TaskGraph graph;
+    graph.add("grid validity patterns", {"pt_order"}, {"calendars"}, [&]() {
+        build_grid_validity_pattern();
+        //build_associated_calendar(); read from database
+    });
+    graph.add("administrative regions", {"pt_order"}, {"admin_links"}, [&]() {
+        build_administrative_regions();
+    });
+    graph.add("odt aggregation", {"pt_order", "admin_links"}, {"admin_odt"}, [&]() { aggregate_odt(); });
+    graph.add("relations", {"pt_order"}, {"relations"}, [&]() { build_relations(); });
+    graph.add("labels", {"pt_order", "admin_links"}, {"labels"}, [&]() { compute_labels(); });
+    graph.add("sort", {"admin_links", "admin_odt", "relations", "labels"}, {"pt_order"}, [&]() {
+        pt_data->sort();
+    });
+    graph.add("proximity lists", {"pt_order"}, {"proximity_lists"}, [&]() { build_proximity_list(); });
+    graph.add("uri maps", {"pt_order"}, {"uri_maps"}, [&]() { build_uri(); });
+    graph.add("autocomplete", {"pt_order", "admin_links"}, {"autocomplete"}, [&]() { build_autocomplete(); });
+
+    log_reports("Data completion:", graph.run());
 }
 
 static ValidityPattern get_union_validity_pattern(const MetaVehicleJourney& meta_vj) {
@@ -644,14 +1089,19 @@ Indexes Data::get_all_index(Type_e type) const {
 Indexes
 Data::get_target_by_source(Type_e source, Type_e target,
                            Indexes source_idx) const {
-    Indexes result;
-    result.reserve(source_idx.size());
+    // the targets are first gathered in a bitset, inserting them one by one
+    // in the flat_set would be quadratic on big fan-outs (network -> vehicle_journey)
+    boost::dynamic_bitset<> targets(get_nb_obj(target));
     for(idx_t idx : source_idx) {
-        Indexes tmp = get_target_by_one_source(source, target, idx);
-        result.insert(/*boost::container::ordered_unique_range_t(),
-                        // Note the tag does not work on old boost version,
-                        //   put it back when we stop boost 1.49 support*/
-                        tmp.begin(), tmp.end());
+        for (idx_t target_idx: get_target_by_one_source(source, target, idx)) {
+            targets.set(target_idx);
+        }
+    }
+    Indexes result;
+    result.reserve(targets.count());
+    for (auto idx = targets.find_first(); idx != targets.npos; idx = targets.find_next(idx)) {
+        // the bitset is iterated in order, the insertion at the end is thus amortized constant
+        result.insert(result.end(), idx);
     }
     return result;
 }
@@ -779,6 +1229,11 @@ struct Pipe {
 };
 } // anonymous namespace
 
+template<typename T>
+static void share_mapped_items(proximitylist::ProximityList<T>& to, const proximitylist::ProximityList<T>& from) {
+    if (from.items.is_mapped()) { to.items = from.items; }
+}
+
 // We want to do a deep clone of a Data.  The problem is that there is a
 // lot of pointers that point to each other, and thus writing a copy
 // assignment operator is really tricky.
@@ -794,6 +1249,11 @@ void Data::clone_from(const Data& from) {
     std::thread write([&]() {boost::archive::binary_oarchive oa(p.out); oa << from;});
     { boost::archive::binary_iarchive ia(p.in); ia >> *this; }
     write.join();
+    // the flat arrays used in place are shared with the clone instead of copied
+    share_mapped_items(pt_data->stop_area_proximity_list, from.pt_data->stop_area_proximity_list);
+    share_mapped_items(pt_data->stop_point_proximity_list, from.pt_data->stop_point_proximity_list);
+    share_mapped_items(geo_ref->poi_proximity_list, from.geo_ref->poi_proximity_list);
+    share_mapped_items(geo_ref->pl, from.geo_ref->pl);
 }
 
 }} //namespace navitia::type
@@ -35,7 +35,10 @@ www.navitia.io
 #include <boost/format.hpp>
 #include <boost/optional.hpp>
 #include <atomic>
+#include <memory>
 #include "type/type.h"
+#include "type/relation_index.h"
+#include "type/temporal_index.h"
 #include "utils/serialization_unique_ptr.h"
 #include "utils/serialization_atomic.h"
 #include "utils/exception.h"
@@ -51,8 +54,15 @@ namespace navitia {
     namespace fare {
         struct Fare;
     }
+    namespace ptref {
+        struct QueryCache;
+    }
+    namespace timetables {
+        struct RouteScheduleCache;
+    }
     namespace routing {
         struct dataRAPTOR;
+        struct PersistedRaptor;
         struct JourneyPattern;
         struct JourneyPatternPoint;
     }
@@ -147,9 +157,18 @@ public:
     /// precomputed data for raptor (public transport routing algorithm)
     std::unique_ptr<navitia::routing::dataRAPTOR> dataRaptor;
 
+    /// dataRaptor as saved in the data file, consumed by build_raptor (not serialized by save/load)
+    std::unique_ptr<navitia::routing::PersistedRaptor> persisted_raptor;
+
     /// Fare data
     std::unique_ptr<navitia::fare::Fare> fare;
 
+    /// precomputed relations between the PT types, used by ptref for its joins
+    std::unique_ptr<RelationIndex> relation_index;
+
+    /// index of the vehicle journeys and impacts by time, used by ptref for its since/until filters
+    std::unique_ptr<TemporalIndex> temporal_index;
+
     // functor to find admins
     std::function<std::vector<georef::Admin*>(const GeographicalCoord&)> find_admins;
 
@@ -200,26 +219,58 @@ public:
 
     mutable std::atomic<bool> is_realtime_loaded;
 
+    // Cache of the ptref query results, null until the data are published
+    // by the DataManager (published data are not mutated anymore, so the
+    // cache is never stale). Mutable for the same reason as above.
+    mutable std::unique_ptr<navitia::ptref::QueryCache> ptref_cache;
+    // Cache of the thermometers and vj orders of the route schedules, same as ptref_cache
+    mutable std::unique_ptr<navitia::timetables::RouteScheduleCache> route_schedule_cache;
+
     Data(size_t data_identifier=0);
     ~Data();
 
+    /** Links between pt_data and geo_ref
+      *
+      * They are serialized apart, as indexes, so that pt_data and geo_ref
+      * can be serialized independently (cf the sections of the data file)
+      */
+    struct CrossReferences {
+        std::vector<std::vector<idx_t>> stop_point_admins;
+        std::vector<std::vector<idx_t>> stop_area_admins;
+        std::vector<std::vector<idx_t>> admin_main_stop_areas;
+        std::vector<std::vector<idx_t>> admin_odt_stop_points;
+
+        template<class Archive> void serialize(Archive & ar, const unsigned int) {
+            ar & stop_point_admins & stop_area_admins & admin_main_stop_areas & admin_odt_stop_points;
+        }
+        void build(const Data&);
+        void apply(Data&) const;
+    };
+
     friend class boost::serialization::access;
+    // the proximity lists are not in the archives of pt_data and geo_ref, a
+    // data file has them as flat arrays (cf save_sections). Defined in data.cpp
+    template<class Archive> void serialize_proximity_lists(Archive& ar) const;
     template<class Archive> void save(Archive & ar, const unsigned int) const {
-        ar & pt_data & geo_ref & meta & fare & last_load_at & loaded & last_load & is_connected_to_rabbitmq
-           & is_realtime_loaded;
+        CrossReferences cross_references;
+        cross_references.build(*this);
+        ar & pt_data & geo_ref & cross_references & meta & fare & last_load_at & loaded & last_load
+           & is_connected_to_rabbitmq & is_realtime_loaded;
+        serialize_proximity_lists(ar);
     }
     template<class Archive> void load(Archive & ar, const unsigned int version) {
-        this->version = version;
-        if(this->version != data_version){
-            unsigned int v = data_version;//sinon ca link pas...
-            auto msg = boost::format("Warning data version don't match with the data version of kraken %u (current version: %d)") % version % v;
-            throw wrong_version(msg.str());
-        }
-        ar & pt_data & geo_ref & meta & fare & last_load_at & loaded & last_load & is_connected_to_rabbitmq
-           & is_realtime_loaded;
+        check_version(version);
+        CrossReferences cross_references;
+        ar & pt_data & geo_ref & cross_references & meta & fare & last_load_at & loaded & last_load
+           & is_connected_to_rabbitmq & is_realtime_loaded;
+        serialize_proximity_lists(ar);
+        cross_references.apply(*this);
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
+    /** throw wrong_version if the version of the serialized data is not the current one */
+    void check_version(unsigned int version);
+
     /** Charge les données et effectue les initialisations nécessaires */
     bool load(const std::string & filename,
             const boost::optional<std::string>& chaos_database = {},
@@ -242,6 +293,15 @@ public:
     /** Construit les données raptor */
     void build_raptor(size_t cache_size = 10);
 
+    /** Materialize the relations between the main PT types (needs dataRaptor) */
+    void build_relation_index();
+
+    /** Index the vehicle journeys and the impacts by time */
+    void build_temporal_index();
+
+    /** Index the impacts by network and day of publication, for the traffic reports */
+    void build_impact_index();
+
     void build_associated_calendar();
 
     void aggregate_odt();
@@ -265,11 +325,39 @@ public:
       */
     void load(std::istream& ifs);
 
+    /** Same as above, from the data file already in memory (typically memory mapped)
+      *
+      * Both the sectioned format (cf save_sections) and the single stream
+      * one are accepted. The flat arrays of a sectioned file are used in
+      * place if keep_alive is given (it must keep the memory alive), copied
+      * otherwise.
+      */
+    void load(const char* begin, size_t size, const std::shared_ptr<const void>& keep_alive = nullptr);
+
+    /** Save in sections (meta, pt_data, geo_ref, fare...) compressed
+      * independently, behind an offset table.
+      *
+      * They are compressed and, at loading, decompressed and deserialized in parallel.
+      * The proximity lists are flat arrays, not compressed, to be used in
+      * place from a memory mapped file.
+      */
+    void save_sections(std::ostream& ofs) const;
+    void load_sections(const char* begin, size_t size, const std::shared_ptr<const void>& keep_alive);
+
     /** Sauvegarde les données en binaire compressé avec LZ4*/
     void save(std::ostream& ifs) const;
 
     // Deep clone from the given Data.
     void clone_from(const Data&);
+
+    /** Start to cache the ptref queries, must be called before sharing the data between threads
+      *
+      * The cache holds at most max_nb_indexes indexes (cf QueryCache)
+      */
+    void enable_ptref_cache(size_t max_nb_indexes = 5 * 1000 * 1000) const;
+
+    /** Start to cache the route schedules computations, as enable_ptref_cache */
+    void enable_route_schedule_cache(size_t max_size = 1000) const;
 private:
     /** Get similar validitypattern **/
     ValidityPattern* get_similar_validity_pattern(ValidityPattern* vp) const;
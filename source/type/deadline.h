@@ -0,0 +1,77 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+#include "utils/exception.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace navitia {
+
+/// thrown when a computation goes beyond the deadline of its request
+struct DeadlineExpired: public recoverable_exception {
+    DeadlineExpired(const std::string& where): recoverable_exception("deadline exceeded during " + where) {}
+};
+
+/**
+ * Deadline of a request
+ *
+ * The long computations (raptor, dijkstra, ptref...) call check() from
+ * time to time and are aborted by a DeadlineExpired once the deadline
+ * is exceeded: nobody will read their answer anyway.
+ * A default constructed deadline never expires.
+ */
+class Deadline {
+    boost::posix_time::ptime expiry; // not_a_date_time if there is no deadline
+public:
+    Deadline() = default;
+    explicit Deadline(const boost::posix_time::ptime& expiry): expiry(expiry) {}
+
+    /// the deadline expires in duration from now, a non positive duration means no deadline
+    void set_in(const boost::posix_time::time_duration& duration) {
+        if (duration <= boost::posix_time::time_duration(0, 0, 0)) {
+            reset();
+            return;
+        }
+        expiry = boost::posix_time::microsec_clock::universal_time() + duration;
+    }
+    void reset() { expiry = boost::posix_time::not_a_date_time; }
+    bool is_set() const { return ! expiry.is_not_a_date_time(); }
+
+    bool expired() const {
+        return is_set() && boost::posix_time::microsec_clock::universal_time() > expiry;
+    }
+    void check(const char* where) const {
+        if (expired()) {
+            throw DeadlineExpired(where);
+        }
+    }
+};
+
+}
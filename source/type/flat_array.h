@@ -0,0 +1,120 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <boost/serialization/split_member.hpp>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace navitia { namespace type {
+
+/** A read only array of trivially copyable elements, used in place in a
+  * memory mapped data file, or owned like a vector
+  *
+  * The array keeps the mapping alive as long as it points into it. Editing
+  * the array (cf edit) copies a mapped array into memory first.
+  *
+  * It is serialized by boost as its elements, a loaded array is owned.
+  */
+template<typename T>
+class FlatArray {
+    static_assert(std::is_trivially_copyable<T>::value, "a FlatArray is memcpy-ed and mapped");
+
+    std::vector<T> owned;
+    // the mapped elements, and what keeps them alive
+    std::shared_ptr<const void> mapping;
+    const T* mapped = nullptr;
+    size_t nb_mapped = 0;
+
+public:
+    bool is_mapped() const { return mapping != nullptr; }
+
+    const T* begin() const { return is_mapped() ? mapped : owned.data(); }
+    const T* end() const { return begin() + size(); }
+    size_t size() const { return is_mapped() ? nb_mapped : owned.size(); }
+    bool empty() const { return size() == 0; }
+    const T& operator[](size_t i) const { return begin()[i]; }
+
+    /// the elements, to be modified
+    std::vector<T>& edit() {
+        if (is_mapped()) {
+            owned.assign(mapped, mapped + nb_mapped);
+            unmap();
+        }
+        return owned;
+    }
+    void clear() {
+        owned.clear();
+        unmap();
+    }
+
+    /** Uses nb elements of the mapping in place, from begin
+      *
+      * begin must be aligned for T, and the mapping must outlive begin
+      */
+    void map(const T* begin, size_t nb, std::shared_ptr<const void> keep_alive) {
+        owned = std::vector<T>();
+        mapped = begin;
+        nb_mapped = nb;
+        mapping = std::move(keep_alive);
+    }
+    /// Copies nb elements from a buffer that may not be aligned
+    void copy(const char* begin, size_t nb) {
+        unmap();
+        owned.resize(nb);
+        if (nb) { std::memcpy(owned.data(), begin, nb * sizeof(T)); }
+    }
+
+    template<class Archive> void save(Archive& ar, const unsigned int) const {
+        size_t nb = size();
+        ar & nb;
+        for (const auto& elt: *this) { ar & elt; }
+    }
+    template<class Archive> void load(Archive& ar, const unsigned int) {
+        size_t nb = 0;
+        ar & nb;
+        unmap();
+        owned.resize(nb);
+        for (auto& elt: owned) { ar & elt; }
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
+
+private:
+    void unmap() {
+        mapping.reset();
+        mapped = nullptr;
+        nb_mapped = 0;
+    }
+};
+
+}} //namespace navitia::type
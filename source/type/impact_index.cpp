@@ -0,0 +1,189 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "type/impact_index.h"
+#include "type/pt_data.h"
+#include <boost/range/algorithm_ext/erase.hpp>
+
+namespace bt = boost::posix_time;
+namespace bg = boost::gregorian;
+
+namespace navitia { namespace type {
+
+namespace {
+
+// the networks of the informed entities of an impact
+struct networks_visitor : public boost::static_visitor<> {
+    const std::vector<std::vector<idx_t>>& networks_by_stop_point;
+    std::vector<idx_t> networks;
+
+    networks_visitor(const std::vector<std::vector<idx_t>>& networks_by_stop_point):
+        networks_by_stop_point(networks_by_stop_point) {}
+
+    void add(const Line* line) {
+        if (line && line->network) { networks.push_back(line->network->idx); }
+    }
+    void add(const VehicleJourney& vj) {
+        if (vj.route) { add(vj.route->line); }
+    }
+
+    void operator()(const disruption::UnknownPtObj&) {}
+    void operator()(const Network* network) { networks.push_back(network->idx); }
+    void operator()(const disruption::LineSection& line_section) { add(line_section.line); }
+    void operator()(const Line* line) { add(line); }
+    void operator()(const Route* route) { add(route->line); }
+    void operator()(const StopPoint* stop_point) {
+        if (stop_point->idx >= networks_by_stop_point.size()) { return; }
+        const auto& sp_networks = networks_by_stop_point[stop_point->idx];
+        networks.insert(networks.end(), sp_networks.begin(), sp_networks.end());
+    }
+    void operator()(const StopArea* stop_area) {
+        for (const auto* stop_point: stop_area->stop_point_list) { (*this)(stop_point); }
+    }
+    void operator()(const MetaVehicleJourney* meta_vj) {
+        meta_vj->for_all_vjs([&](const VehicleJourney& vj) { add(vj); });
+    }
+};
+
+} // anonymous namespace
+
+void ImpactIndex::build(const PT_Data& pt_data,
+                        const bg::date_period& period,
+                        std::vector<std::vector<idx_t>> networks_by_sp) {
+    production_period = period;
+    impacts_by_network.clear();
+    indexed_impacts.clear();
+    networks_by_stop_point = std::move(networks_by_sp);
+    built = true;
+    generation = pt_data.disruption_holder.get_generation();
+    for (const auto& weak_impact: pt_data.disruption_holder.get_weak_impacts()) {
+        if (const auto impact = weak_impact.lock()) {
+            insert(impact);
+        }
+    }
+}
+
+bool ImpactIndex::insert(const boost::shared_ptr<disruption::Impact>& impact) {
+    // apply_disruption can be called again on an already indexed impact
+    if (indexed_impacts.count(impact.get())) { return false; }
+    networks_visitor v(networks_by_stop_point);
+    for (auto& entity: impact->informed_entities) {
+        boost::apply_visitor(v, entity);
+    }
+    auto& indexed = indexed_impacts[impact.get()];
+    indexed.networks = std::move(v.networks);
+    auto& networks = indexed.networks;
+    std::sort(networks.begin(), networks.end());
+    networks.erase(std::unique(networks.begin(), networks.end()), networks.end());
+
+    const auto& publication_period = impact->disruption->publication_period;
+    if (publication_period.is_null() || production_period.is_null()) { return true; }
+    const auto first_day = std::max(publication_period.begin().date(), production_period.begin());
+    const auto last_day = std::min(publication_period.last().date(), production_period.last());
+    indexed.first_day = (first_day - production_period.begin()).days();
+    indexed.last_day = (last_day - production_period.begin()).days();
+    for (const auto network_idx: networks) {
+        if (network_idx >= impacts_by_network.size()) {
+            impacts_by_network.resize(network_idx + 1);
+        }
+        auto& days = impacts_by_network[network_idx];
+        days.resize(production_period.length().days());
+        for (auto day = indexed.first_day; day <= indexed.last_day; ++day) {
+            days[day].push_back(impact);
+        }
+    }
+    return true;
+}
+
+void ImpactIndex::erase(const boost::shared_ptr<disruption::Impact>& impact) {
+    const auto it = indexed_impacts.find(impact.get());
+    if (it == indexed_impacts.end()) { return; }
+    const auto& indexed = it->second;
+    // only the days the impact has been inserted in
+    for (const auto network_idx: indexed.networks) {
+        if (network_idx >= impacts_by_network.size()) { continue; }
+        auto& days = impacts_by_network[network_idx];
+        for (auto day = indexed.first_day; day <= indexed.last_day && day < long(days.size()); ++day) {
+            boost::range::remove_erase_if(days[day], [&](const boost::weak_ptr<disruption::Impact>& i) {
+                const auto spt = i.lock();
+                return ! spt || spt == impact;
+            });
+        }
+    }
+    indexed_impacts.erase(it);
+}
+
+void ImpactIndex::add(const disruption::Disruption& disruption, const PT_Data& pt_data) {
+    if (! built) { return; }
+    // each new impact has incremented the generation of the holder,
+    // the index catches up only if nothing else has changed since
+    size_t nb_new_impacts = 0;
+    for (const auto& impact: disruption.get_impacts()) {
+        if (insert(impact)) { ++nb_new_impacts; }
+    }
+    if (generation + nb_new_impacts == pt_data.disruption_holder.get_generation()) {
+        generation += nb_new_impacts;
+    }
+}
+
+void ImpactIndex::remove(const disruption::Disruption& disruption, const disruption::DisruptionHolder& holder) {
+    if (! built) { return; }
+    for (const auto& impact: disruption.get_impacts()) {
+        erase(impact);
+    }
+    // popping the disruption has incremented the generation of the holder
+    if (generation + 1 == holder.get_generation()) {
+        ++generation;
+    }
+}
+
+bool ImpactIndex::can_answer(const bt::ptime& now, const disruption::DisruptionHolder& holder) const {
+    // the impacts created without apply_disruption (or before the build) are not indexed
+    if (! built || generation != holder.get_generation()) { return false; }
+    return ! now.is_not_a_date_time() && production_period.contains(now.date());
+}
+
+std::vector<boost::shared_ptr<disruption::Impact>>
+ImpactIndex::get_publishable_impacts(const Network& network, const bt::ptime& now) const {
+    std::vector<boost::shared_ptr<disruption::Impact>> res;
+    if (network.idx >= impacts_by_network.size()) { return res; }
+    const auto& days = impacts_by_network[network.idx];
+    const auto day = (now.date() - production_period.begin()).days();
+    if (day < 0 || day >= long(days.size())) { return res; }
+    for (const auto& weak_impact: days[day]) {
+        const auto impact = weak_impact.lock();
+        if (impact && impact->disruption->is_publishable(now)) {
+            res.push_back(impact);
+        }
+    }
+    return res;
+}
+
+}} //namespace navitia::type
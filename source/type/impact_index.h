@@ -0,0 +1,108 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/type_interfaces.h"
+#include <boost/date_time/gregorian/gregorian_types.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace navitia { namespace type {
+
+struct PT_Data;
+struct Network;
+namespace disruption {
+struct Impact;
+struct Disruption;
+class DisruptionHolder;
+}
+
+/** Index of the impacts by network and by day of publication
+  *
+  * An impact is indexed in the networks of its informed entities: the network
+  * itself, the network of the line (or line section, or route), the networks
+  * of the lines stopping at the stop area or stop point, and the networks
+  * of the vehicle journeys of the meta vehicle journey. For each day of the
+  * production period, the impacts whose disruption is published this day.
+  *
+  * It is built by Data::build_raptor, with the networks of the stop points
+  * taken from dataRaptor, and kept up to date by apply_disruption and
+  * delete_disruption. It is not serialized.
+  *
+  * The index is up to date as long as it is at the generation of the
+  * DisruptionHolder: an impact created without apply_disruption makes it stale.
+  */
+class ImpactIndex {
+    boost::gregorian::date_period production_period{boost::gregorian::date(), boost::gregorian::date()};
+    // impacts_by_network[network idx][day of the production period]
+    std::vector<std::vector<std::vector<boost::weak_ptr<disruption::Impact>>>> impacts_by_network;
+    // where the indexed impacts are, to remove them
+    struct Indexed {
+        std::vector<idx_t> networks;
+        // the days of the production period, empty if first_day > last_day
+        long first_day = 0;
+        long last_day = -1;
+    };
+    std::unordered_map<const disruption::Impact*, Indexed> indexed_impacts;
+    // networks_by_stop_point[stop point idx], sorted
+    std::vector<std::vector<idx_t>> networks_by_stop_point;
+    bool built = false;
+    // the generation of the DisruptionHolder the index is up to date with
+    size_t generation = 0;
+
+    // true if the impact was not yet indexed
+    bool insert(const boost::shared_ptr<disruption::Impact>& impact);
+    void erase(const boost::shared_ptr<disruption::Impact>& impact);
+
+public:
+    /// networks_by_stop_point are the networks of the lines stopping at each
+    /// stop point, the stop points created afterwards have no network
+    void build(const PT_Data& pt_data,
+               const boost::gregorian::date_period& production_period,
+               std::vector<std::vector<idx_t>> networks_by_stop_point);
+
+    /// to be called once the impacts of the disruption have been created
+    void add(const disruption::Disruption& disruption, const PT_Data& pt_data);
+    /// to be called once the disruption has been popped from the holder
+    void remove(const disruption::Disruption& disruption, const disruption::DisruptionHolder& holder);
+
+    /// false if the index is not up to date with the impacts, or the date is out of the production period
+    bool can_answer(const boost::posix_time::ptime& now, const disruption::DisruptionHolder& holder) const;
+
+    /// The impacts of the network whose disruption is publishable now, can_answer(now) must be true
+    std::vector<boost::shared_ptr<disruption::Impact>>
+    get_publishable_impacts(const Network& network, const boost::posix_time::ptime& now) const;
+};
+
+}} //namespace navitia::type
@@ -159,11 +159,13 @@ std::unique_ptr<Disruption> DisruptionHolder::pop_disruption(const std::string&
     }
     auto res = std::move(it->second);
     disruptions_by_uri.erase(it);
+    ++generation;
     return res;
 }
 
 void DisruptionHolder::add_weak_impact(boost::weak_ptr<Impact> weak_impact) {
     weak_impacts.push_back(weak_impact);
+    ++generation;
 }
 
 void DisruptionHolder::clean_weak_impacts(){
@@ -330,6 +330,8 @@ private:
 class DisruptionHolder {
     std::map<std::string, std::unique_ptr<Disruption>> disruptions_by_uri;
     std::vector<boost::weak_ptr<Impact>> weak_impacts;
+    // incremented each time an impact is added or a disruption removed (not serialized)
+    size_t generation = 0;
 public:
     Disruption& make_disruption(const std::string& uri, type::RTLevel lvl);
     std::unique_ptr<Disruption> pop_disruption(const std::string& uri);
@@ -338,6 +340,7 @@ public:
     void clean_weak_impacts();
     const std::vector<boost::weak_ptr<Impact>>&
     get_weak_impacts() const{ return weak_impacts;}
+    size_t get_generation() const { return generation; }
     // causes, severities and tags are a pool (weak_ptr because the owner ship
     // is in the linked disruption or impact)
     std::map<std::string, boost::weak_ptr<Cause>> causes; //to be wrapped
@@ -307,7 +307,7 @@ void PbCreator::Filler::add_contributor(const T* nav) {
     const auto& contributors = ptref_indexes<nt::Contributor>(nav);
     for(const nt::Contributor* c: contributors){
         if (! c->license.empty()){
-            pb_creator.contributors.insert(c);
+            pb_creator.register_contributor(c);
         }
     }
 }
@@ -315,19 +315,19 @@ void PbCreator::Filler::add_contributor(const T* nav) {
 template<typename NAV, typename PB>
 void PbCreator::Filler::fill(NAV* nav_object, PB* pb_object) {
     if (nav_object == nullptr) { return; }
-    copy(depth-1, dump_message).fill_pb_object(nav_object, get_sub_object(nav_object, pb_object));
+    copy(depth-1, dump_message).fill_memoized(nav_object, get_sub_object(nav_object, pb_object));
 }
 template<typename NAV, typename F>
 void PbCreator::Filler::fill_with_creator(NAV* nav_object, F creator) {
     if (nav_object == nullptr) { return; }
-    copy(depth-1, dump_message).fill_pb_object(nav_object, creator());
+    copy(depth-1, dump_message).fill_memoized(nav_object, creator());
 }
 
 template<typename T>
 void PbCreator::Filler::fill_pb_object(const T* value, pbnavitia::PtObject* pt_object) {
     if(value == nullptr) { return; }
 
-    copy(depth, dump_message).fill_pb_object(value, get_sub_object(value, pt_object));
+    copy(depth, dump_message).fill_memoized(value, get_sub_object(value, pt_object));
     pt_object->set_name(get_label(value));
     pt_object->set_uri(value->uri);
 //    add_contributor(value);
@@ -604,9 +604,8 @@ void PbCreator::Filler::fill_pb_object(const nt::Route* r, pbnavitia::Route* rou
     fill(&r->shape, route);
 
     if (depth>2) {
-        auto thermometer = navitia::timetables::Thermometer();
-        thermometer.generate_thermometer(r);
-        for(auto idx : thermometer.get_thermometer()) {
+        const auto thermometer = navitia::timetables::get_thermometer(r, pb_creator.data);
+        for(auto idx : thermometer->get_thermometer()) {
             auto stop_point = pb_creator.data.pt_data->stop_points[idx];
             fill_with_creator(stop_point, [&](){return route->add_stop_points();});
         }
@@ -907,7 +906,7 @@ template <typename P>
 void PbCreator::Filler::fill_message(const boost::shared_ptr<nt::disruption::Impact>& impact,
                                      P pb_object){
     *pb_object->add_impact_uris() = impact->uri;
-    pb_creator.impacts.insert(impact);
+    pb_creator.register_impact(impact);
 }
 template void navitia::PbCreator::Filler::fill_message<pbnavitia::Network*>(boost::shared_ptr<navitia::type::disruption::Impact> const&, pbnavitia::Network*);
 template void navitia::PbCreator::Filler::fill_message<pbnavitia::Line*>(boost::shared_ptr<navitia::type::disruption::Impact> const&, pbnavitia::Line*);
@@ -1134,7 +1133,7 @@ void PbCreator::Filler::fill_pb_object(const VjStopTimes* vj_stoptimes,
     if (vj_stoptimes->vj->dataset && vj_stoptimes->vj->dataset->contributor
         // Only contributor with license
         &&(!vj_stoptimes->vj->dataset->contributor->license.empty())){
-        this->pb_creator.contributors.insert(vj_stoptimes->vj->dataset->contributor);
+        this->pb_creator.register_contributor(vj_stoptimes->vj->dataset->contributor);
     }
     if (depth > 0 && vj_stoptimes->vj->route) {
         fill_with_creator(vj_stoptimes->vj->route, [&](){return pt_display_info;});
@@ -1754,6 +1753,37 @@ void PbCreator::fill_pb_error(const pbnavitia::Error::error_id id, const std::st
     error->set_message(message);
 }
 
+void PbCreator::register_contributor(const nt::Contributor* contributor) {
+    contributors.insert(contributor);
+    for (auto* filled: recording_objects) {
+        filled->contributors.push_back(contributor);
+    }
+}
+
+void PbCreator::register_impact(const boost::shared_ptr<type::disruption::Impact>& impact) {
+    impacts.insert(impact);
+    for (auto* filled: recording_objects) {
+        filled->impacts.push_back(impact);
+    }
+}
+
+void PbCreator::register_period_dependency() {
+    for (auto* filled: recording_objects) {
+        filled->depends_on_period = true;
+    }
+}
+
+void PbCreator::replay(const FilledObject& filled) {
+    for (const auto* contributor: filled.contributors) {
+        register_contributor(contributor);
+    }
+    for (const auto& impact: filled.impacts) {
+        register_impact(impact);
+    }
+    // the fillings in progress copying this one depend on the period like it
+    if (filled.depends_on_period) { register_period_dependency(); }
+}
+
 pbnavitia::Response PbCreator::get_response(){
     Filler(0, DumpMessage::No, *this).fill_pb_object(contributors, response.mutable_feed_publishers());
     Filler(0, DumpMessage::No, *this).fill_pb_object(impacts, response.mutable_impacts());
@@ -36,6 +36,11 @@ www.navitia.io
 #include "vptranslator/vptranslator.h"
 #include "ptreferential/ptreferential.h"
 
+#include <map>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
 namespace pt = boost::posix_time;
 namespace nt = navitia::type;
 namespace ng = navitia::georef;
@@ -142,6 +147,25 @@ template<typename T>
 std::string get_label(const T* v) {
     return detail::get_label_if_exists(v, 0);
 }
+
+/**
+ * is_memoized<Nav, Pb> tells if a Nav object filled in a Pb message is kept by the
+ * PbCreator to be copied the next time it is needed in the same response.
+ *
+ * Only the small objects shared by a lot of sections, lines and stops are memoized,
+ * their filling does only depend on the object, the depth, the DumpMessage and,
+ * if an object of the filling has impacts, on now and the action_period.
+ */
+namespace detail {
+template<typename Nav, typename Pb> struct is_memoized: std::false_type {};
+template<> struct is_memoized<nt::StopArea, pbnavitia::StopArea>: std::true_type {};
+template<> struct is_memoized<nt::StopPoint, pbnavitia::StopPoint>: std::true_type {};
+template<> struct is_memoized<nt::Line, pbnavitia::Line>: std::true_type {};
+template<> struct is_memoized<nt::Network, pbnavitia::Network>: std::true_type {};
+template<> struct is_memoized<nt::CommercialMode, pbnavitia::CommercialMode>: std::true_type {};
+template<> struct is_memoized<nt::PhysicalMode, pbnavitia::PhysicalMode>: std::true_type {};
+template<> struct is_memoized<ng::Admin, pbnavitia::AdministrativeRegion>: std::true_type {};
+}
 inline pbnavitia::NavitiaType get_embedded_type(const nt::Calendar*) { return pbnavitia::CALENDAR; }
 inline pbnavitia::NavitiaType get_embedded_type(const nt::VehicleJourney*) { return pbnavitia::VEHICLE_JOURNEY; }
 inline pbnavitia::NavitiaType get_embedded_type(const nt::Line*) { return pbnavitia::LINE; }
@@ -252,6 +276,29 @@ struct PbCreator {
 private:
 
     pbnavitia::Response response;
+
+    // Memo of the sub-objects already filled for this response (stop_area, line, network...),
+    // with the contributors and impacts they added, to replay them.
+    struct FilledObject {
+        std::unique_ptr<google::protobuf::Message> pb;
+        std::vector<const nt::Contributor*> contributors;
+        std::vector<boost::shared_ptr<type::disruption::Impact>> impacts;
+        // an object of the filling has impacts, they depend on now and on the action_period
+        bool depends_on_period = false;
+    };
+    // the action_period changes for each section, so now and the action_period
+    // are only in the key of the fillings that depend on them, not_a_date_time otherwise
+    using FilledKey = std::tuple<const void*, const google::protobuf::Descriptor*, int, DumpMessage,
+                                 pt::ptime, pt::ptime, pt::ptime>;
+    std::map<FilledKey, FilledObject> filled_objects;
+    // memoized fillings in progress, the most nested last
+    std::vector<FilledObject*> recording_objects;
+
+    void register_contributor(const nt::Contributor* contributor);
+    void register_impact(const boost::shared_ptr<type::disruption::Impact>& impact);
+    void register_period_dependency();
+    void replay(const FilledObject& filled);
+
     struct Filler {
         struct PtObjVisitor;
         const int depth;
@@ -267,6 +314,45 @@ private:
         void fill(NAV* nav_object, PB* pb_object);
         template<typename NAV, typename F>
         void fill_with_creator(NAV* nav_object, F creator);
+        FilledKey period_key(FilledKey key) const {
+            std::get<4>(key) = pb_creator.now;
+            std::get<5>(key) = pb_creator.action_period.begin();
+            std::get<6>(key) = pb_creator.action_period.end();
+            return key;
+        }
+        // fill pb_object, copying the sub-object if it has already been filled for this response
+        template<typename NAV, typename PB>
+        void fill_memoized(const NAV* nav_object, PB* pb_object) {
+            if (! detail::is_memoized<NAV, PB>::value) {
+                fill_pb_object(nav_object, pb_object);
+                return;
+            }
+            auto& filled_objects = pb_creator.filled_objects;
+            const auto key = FilledKey(nav_object, PB::descriptor(), depth, dump_message,
+                                       pt::not_a_date_time, pt::not_a_date_time, pt::not_a_date_time);
+            auto it = filled_objects.find(key);
+            if (it == filled_objects.end()) {
+                it = filled_objects.find(period_key(key));
+            }
+            if (it == filled_objects.end()) {
+                FilledObject filled;
+                auto* pb = new PB();
+                filled.pb.reset(pb);
+                pb_creator.recording_objects.push_back(&filled);
+                try {
+                    fill_pb_object(nav_object, pb);
+                } catch (...) {
+                    pb_creator.recording_objects.pop_back();
+                    throw;
+                }
+                pb_creator.recording_objects.pop_back();
+                const auto filled_key = filled.depends_on_period ? period_key(key) : key;
+                it = filled_objects.emplace(filled_key, std::move(filled)).first;
+            } else {
+                pb_creator.replay(it->second);
+            }
+            pb_object->MergeFrom(static_cast<const PB&>(*it->second.pb));
+        }
 
         template<typename NAV, typename PB>
         void fill(const NAV& nav_object, PB* pb_object) {
@@ -277,7 +363,7 @@ private:
         void fill_pb_object(const std::vector<Nav*>& nav_list,
                             ::google::protobuf::RepeatedPtrField<Pb>* pb_list) {
             for (auto* nav_obj: nav_list) {
-                fill_pb_object(nav_obj, pb_list->Add());
+                fill_memoized(nav_obj, pb_list->Add());
             }
         }
 
@@ -285,7 +371,7 @@ private:
         void fill_pb_object(const std::vector<Nav>& nav_list,
                             ::google::protobuf::RepeatedPtrField<Pb>* pb_list) {
             for (auto& nav_obj: nav_list) {
-                fill_pb_object(&nav_obj, pb_list->Add());
+                fill_memoized(&nav_obj, pb_list->Add());
             }
         }
 
@@ -293,21 +379,21 @@ private:
         void fill_pb_object(const std::set<Nav>& nav_list,
                             ::google::protobuf::RepeatedPtrField<Pb>* pb_list) {
             for (auto& nav_obj: nav_list) {
-                fill_pb_object(&nav_obj, pb_list->Add());
+                fill_memoized(&nav_obj, pb_list->Add());
             }
         }
         template<typename Nav, typename Pb>
         void fill_pb_object(const std::set<Nav*>& nav_list,
                             ::google::protobuf::RepeatedPtrField<Pb>* pb_list) {
             for (auto* nav_obj: nav_list) {
-                fill_pb_object(nav_obj, pb_list->Add());
+                fill_memoized(nav_obj, pb_list->Add());
             }
         }
         template<typename Nav, typename Pb>
         void fill_pb_object(const std::set<boost::shared_ptr<Nav>>& nav_list,
                             ::google::protobuf::RepeatedPtrField<Pb>* pb_list) {
             for (auto& nav_obj: nav_list) {
-                fill_pb_object(nav_obj.get(), pb_list->Add());
+                fill_memoized(nav_obj.get(), pb_list->Add());
             }
         }
 
@@ -315,6 +401,7 @@ private:
         void fill_messages(const nt::HasMessages* nav_obj, P* pb_obj){
             if (nav_obj == nullptr) {return ;}
             if (dump_message == DumpMessage::No) { return; }
+            if (nav_obj->has_impacts()) { pb_creator.register_period_dependency(); }
             for (const auto& message : nav_obj->get_applicable_messages(pb_creator.now,
                                                                         pb_creator.action_period)){
                 fill_message(message, pb_obj);
@@ -217,6 +217,34 @@ PT_Data::get_impacts_idx(const std::vector<boost::shared_ptr<disruption::Impact>
     return result;
 }
 
+const std::vector<VehicleJourney*>& PT_Data::get_vehicle_journeys(const StopPoint& stop_point) {
+    if (! vjs_by_stop_point_built) {
+        vjs_by_stop_point.assign(stop_points.size(), {});
+        vjs_by_stop_point_built = true;
+        for (auto* vj: vehicle_journeys) {
+            add_to_vjs_by_stop_point(vj);
+        }
+    }
+    if (stop_point.idx >= vjs_by_stop_point.size()) {
+        vjs_by_stop_point.resize(stop_point.idx + 1);
+    }
+    return vjs_by_stop_point[stop_point.idx];
+}
+
+void PT_Data::add_to_vjs_by_stop_point(VehicleJourney* vj) {
+    if (! vjs_by_stop_point_built) { return; }
+    for (const auto& st: vj->stop_time_list) {
+        if (st.stop_point->idx >= vjs_by_stop_point.size()) {
+            vjs_by_stop_point.resize(st.stop_point->idx + 1);
+        }
+        auto& vjs = vjs_by_stop_point[st.stop_point->idx];
+        // a vj can stop several times at the same stop point
+        if (vjs.empty() || vjs.back() != vj) {
+            vjs.push_back(vj);
+        }
+    }
+}
+
 const StopPointConnection*
 PT_Data::get_stop_point_connection(const StopPoint& from, const StopPoint& to) const {
     const auto& connections = from.stop_point_connection_list;
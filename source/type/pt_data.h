@@ -42,6 +42,7 @@ www.navitia.io
 #include "comment_container.h"
 #include "code_container.h"
 #include "headsign_handler.h"
+#include "impact_index.h"
 
 #include <boost/serialization/map.hpp>
 #include "utils/serialization_unordered_map.h"
@@ -79,11 +80,14 @@ struct PT_Data : boost::noncopyable{
     autocomplete::Autocomplete<idx_t> route_autocomplete = autocomplete::Autocomplete<idx_t>(navitia::type::Type_e::Route);
 
     // Proximity list
+    // the proximity lists are serialized by Data, as flat arrays in a data file
     proximitylist::ProximityList<idx_t> stop_area_proximity_list;
     proximitylist::ProximityList<idx_t> stop_point_proximity_list;
 
     //Message
     disruption::DisruptionHolder disruption_holder;
+    // impacts by network and day for the traffic reports, not serialized
+    ImpactIndex impact_index;
 
     // rtree for zonal stop_points
     MultiPolygonMap<const StopPoint*> stop_points_by_area;
@@ -116,7 +120,6 @@ struct PT_Data : boost::noncopyable{
                 ITERATE_NAVITIA_PT_TYPES(SERIALIZE_ELEMENTS)
                 & stop_area_autocomplete & stop_point_autocomplete & line_autocomplete
                 & network_autocomplete & mode_autocomplete & route_autocomplete
-                & stop_area_proximity_list & stop_point_proximity_list
                 & stop_point_connections
                 & disruption_holder
                 & meta_vjs
@@ -161,6 +164,11 @@ struct PT_Data : boost::noncopyable{
 
     type::ValidityPattern* get_or_create_validity_pattern(const ValidityPattern& vp_ref);
 
+    /// the vehicle journeys (of all rt levels) stopping at the stop point
+    const std::vector<VehicleJourney*>& get_vehicle_journeys(const StopPoint& stop_point);
+    /// to be called on each new vj to keep get_vehicle_journeys up to date
+    void add_to_vjs_by_stop_point(VehicleJourney* vj);
+
     /** Retrouve un élément par un attribut arbitraire de type chaine de caractères
       *
       * Le template a été surchargé pour gérer des const char* (string passée comme literal)
@@ -181,6 +189,12 @@ struct PT_Data : boost::noncopyable{
 
     ~PT_Data();
 
+private:
+    // vjs by stop point idx. It is not serialized, it is built at the
+    // first use (ie the first disruption on a stop point applied on this
+    // data) as the vjs are never deleted, adding the new ones is enough
+    std::vector<std::vector<VehicleJourney*>> vjs_by_stop_point;
+    bool vjs_by_stop_point_built = false;
 };
 
 }
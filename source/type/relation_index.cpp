@@ -0,0 +1,61 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "type/relation_index.h"
+#include "type/data.h"
+
+namespace navitia { namespace type {
+
+static Relation build_relation(const Data& data, Type_e source, Type_e target) {
+    Relation relation;
+    const size_t nb_sources = data.get_nb_obj(source);
+    relation.offsets.reserve(nb_sources + 1);
+    relation.offsets.push_back(0);
+    relation.nb_target_objects = data.get_nb_obj(target);
+    for (idx_t idx = 0; idx < nb_sources; ++idx) {
+        // get_target_by_one_source gives sorted targets, they stay sorted in the row
+        for (const idx_t target_idx: data.get_target_by_one_source(source, target, idx)) {
+            relation.targets.push_back(target_idx);
+        }
+        relation.offsets.push_back(relation.targets.size());
+    }
+    relation.targets.shrink_to_fit();
+    return relation;
+}
+
+void RelationIndex::build(const Data& data, const std::vector<std::pair<Type_e, Type_e>>& pairs) {
+    relations.clear();
+    relations.reserve(pairs.size());
+    for (const auto& pair: pairs) {
+        relations[pair] = build_relation(data, pair.first, pair.second);
+    }
+}
+
+}} //namespace navitia::type
@@ -0,0 +1,83 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/type_interfaces.h"
+#include <boost/container/flat_map.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <vector>
+
+namespace navitia { namespace type {
+
+class Data;
+
+/** Relation between all the objects of a source type and the objects of a target type
+  *
+  * The relation is stored in compressed sparse rows: the targets of the
+  * source i are targets[offsets[i]], ..., targets[offsets[i + 1] - 1].
+  * Walking a relation is thus a walk on 2 contiguous arrays.
+  */
+struct Relation {
+    std::vector<uint32_t> offsets; // nb_sources + 1 elements
+    std::vector<idx_t> targets;
+    size_t nb_target_objects = 0; // number of objects of the target type when built
+
+    size_t nb_sources() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t nb_targets() const { return nb_target_objects; }
+
+    boost::iterator_range<std::vector<idx_t>::const_iterator> get(const idx_t source_idx) const {
+        return boost::make_iterator_range(targets.begin() + offsets[source_idx],
+                                          targets.begin() + offsets[source_idx + 1]);
+    }
+};
+
+/** Relations between the main PT types, materialized once the data are loaded
+  *
+  * It's only a cache of Data::get_target_by_one_source, it is thus not
+  * serialized and rebuilt by Data::build_raptor.
+  */
+class RelationIndex {
+    boost::container::flat_map<std::pair<Type_e, Type_e>, Relation> relations;
+public:
+    /// build the relations of all the given (source, target) pairs
+    void build(const Data& data, const std::vector<std::pair<Type_e, Type_e>>& pairs);
+
+    /// null if the relation has not been materialized
+    const Relation* get(Type_e source, Type_e target) const {
+        const auto it = relations.find({source, target});
+        if (it == relations.end()) { return nullptr; }
+        return &it->second;
+    }
+
+    size_t size() const { return relations.size(); }
+};
+
+}} //namespace navitia::type
@@ -0,0 +1,157 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "type/task_graph.h"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <log4cplus/logger.h>
+#include <log4cplus/loggingmacros.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+
+namespace pt = boost::posix_time;
+
+namespace navitia { namespace type {
+
+static bool intersects(const std::set<std::string>& a, const std::set<std::string>& b) {
+    return std::any_of(a.begin(), a.end(), [&](const std::string& s) { return b.count(s); });
+}
+
+// value in kB of a field (like VmRSS) of /proc/self/status, 0 if not available
+static long read_proc_status_kb(const std::string& field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size() + 1, field + ":") != 0) { continue; }
+        try {
+            return std::stol(line.substr(field.size() + 1));
+        } catch (const std::exception&) {
+            return 0;
+        }
+    }
+    return 0;
+}
+
+void TaskGraph::add(const std::string& name,
+                    const std::set<std::string>& reads,
+                    const std::set<std::string>& writes,
+                    std::function<void()> function) {
+    Task task{name, reads, writes, std::move(function), {}};
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        const auto& other = tasks[i];
+        if (intersects(reads, other.writes)
+            || intersects(writes, other.writes)
+            || intersects(writes, other.reads)) {
+            task.dependencies.push_back(i);
+        }
+    }
+    tasks.push_back(std::move(task));
+}
+
+std::vector<TaskGraph::Report> TaskGraph::run(size_t nb_threads) {
+    std::vector<Report> reports(tasks.size());
+    std::vector<size_t> nb_waited(tasks.size());
+    std::vector<std::vector<size_t>> dependents(tasks.size());
+    std::deque<size_t> ready;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        nb_waited[i] = tasks[i].dependencies.size();
+        for (const auto dep: tasks[i].dependencies) { dependents[dep].push_back(i); }
+        if (nb_waited[i] == 0) { ready.push_back(i); }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t nb_running = 0;
+    std::exception_ptr error;
+
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [&]() { return error || ! ready.empty() || nb_running == 0; });
+            // as a task only depends on the previous ones, nothing ready and
+            // nothing running means that everything has been done
+            if (error || ready.empty()) { return; }
+            const size_t i = ready.front();
+            ready.pop_front();
+            ++nb_running;
+            lock.unlock();
+
+            std::exception_ptr task_error;
+            const auto start = pt::microsec_clock::universal_time();
+            try {
+                tasks[i].function();
+            } catch (...) {
+                task_error = std::current_exception();
+            }
+            auto& report = reports[i];
+            report.name = tasks[i].name;
+            report.duration_ms = (pt::microsec_clock::universal_time() - start).total_milliseconds();
+            report.rss_kb = read_proc_status_kb("VmRSS");
+            report.peak_rss_kb = read_proc_status_kb("VmHWM");
+
+            lock.lock();
+            --nb_running;
+            if (task_error) {
+                if (! error) { error = task_error; }
+            } else {
+                for (const auto dependent: dependents[i]) {
+                    if (--nb_waited[dependent] == 0) { ready.push_back(dependent); }
+                }
+            }
+            cv.notify_all();
+        }
+    };
+
+    nb_threads = std::max<size_t>(1, std::min(nb_threads, tasks.size()));
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < nb_threads; ++i) { threads.emplace_back(worker); }
+    for (auto& thread: threads) { thread.join(); }
+    if (error) { std::rethrow_exception(error); }
+    return reports;
+}
+
+void log_reports(const std::string& title, std::vector<TaskGraph::Report> reports) {
+    auto logger = log4cplus::Logger::getInstance("log");
+    std::sort(reports.begin(), reports.end(), [](const TaskGraph::Report& a, const TaskGraph::Report& b) {
+        return a.duration_ms > b.duration_ms;
+    });
+    LOG4CPLUS_INFO(logger, title);
+    for (const auto& report: reports) {
+        LOG4CPLUS_INFO(logger, "\t " << report.name << ": " << report.duration_ms << "ms"
+                       << ", rss: " << report.rss_kb / 1024 << "MB"
+                       << ", peak rss: " << report.peak_rss_kb / 1024 << "MB");
+    }
+}
+
+}} // namespace navitia::type
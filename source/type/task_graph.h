@@ -0,0 +1,92 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+
+namespace navitia { namespace type {
+
+/** A small graph of tasks executed on a pool of threads
+  *
+  * Each task declares the resources (free names, like "admin_links") it
+  * reads and writes. A task depends on the previously added tasks
+  * writing what it reads, or reading or writing what it writes, so
+  * running the graph gives the same result as running the tasks
+  * sequentially in the order they have been added.
+  *
+  * For each task, its duration and the memory of the process at its end
+  * are reported (the peak is the one of the whole process, as the tasks
+  * share it).
+  */
+class TaskGraph {
+public:
+    struct Report {
+        std::string name;
+        long duration_ms = 0;
+        long rss_kb = 0; // resident memory at the end of the task
+        long peak_rss_kb = 0; // peak resident memory of the process at the end of the task
+    };
+
+    void add(const std::string& name,
+             const std::set<std::string>& reads,
+             const std::set<std::string>& writes,
+             std::function<void()> task);
+
+    /** Runs all the tasks, the dependencies first
+      *
+      * If a task throws, the tasks not yet started are not run and the
+      * first exception is thrown once the running ones are finished.
+      */
+    std::vector<Report> run(size_t nb_threads = std::thread::hardware_concurrency());
+
+    // indexes of the tasks the i-th one depends on
+    const std::vector<size_t>& get_dependencies(size_t i) const { return tasks.at(i).dependencies; }
+    size_t size() const { return tasks.size(); }
+
+private:
+    struct Task {
+        std::string name;
+        std::set<std::string> reads;
+        std::set<std::string> writes;
+        std::function<void()> function;
+        std::vector<size_t> dependencies;
+    };
+    std::vector<Task> tasks;
+};
+
+/// Logs the reports, the longest tasks first
+void log_reports(const std::string& title, std::vector<TaskGraph::Report> reports);
+
+}} // namespace navitia::type
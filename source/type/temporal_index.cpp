@@ -0,0 +1,140 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "type/temporal_index.h"
+#include "type/pt_data.h"
+
+namespace bt = boost::posix_time;
+namespace bg = boost::gregorian;
+
+namespace navitia { namespace type {
+
+void TemporalIndex::build(const PT_Data& pt_data) {
+    nb_vjs = pt_data.vehicle_journeys.size();
+    vjs_by_day.clear();
+    vjs_by_departure.clear();
+    sorted_departures.clear();
+    beginning_date = bg::date();
+
+    std::vector<std::pair<uint32_t, idx_t>> departures;
+    for (const auto* vj: pt_data.vehicle_journeys) {
+        // no stop time, so it cannot be valid
+        if (vj->stop_time_list.empty()) { continue; }
+        const auto* vp = vj->base_validity_pattern();
+        if (beginning_date.is_not_a_date()) {
+            beginning_date = vp->beginning_date;
+            vjs_by_day.assign(vp->days.size(), boost::dynamic_bitset<>(nb_vjs));
+        } else if (beginning_date != vp->beginning_date) {
+            // the validity patterns are not aligned, the index is useless
+            beginning_date = bg::date();
+            vjs_by_day.clear();
+            break;
+        }
+        for (size_t day = 0; day < vp->days.size(); ++day) {
+            if (vp->days[day]) { vjs_by_day[day].set(vj->idx); }
+        }
+        departures.push_back({vj->stop_time_list.front().departure_time, vj->idx});
+    }
+    std::sort(departures.begin(), departures.end());
+    vjs_by_departure.reserve(departures.size());
+    sorted_departures.reserve(departures.size());
+    for (const auto& departure: departures) {
+        sorted_departures.push_back(departure.first);
+        vjs_by_departure.push_back(departure.second);
+    }
+
+    const auto& weak_impacts = pt_data.disruption_holder.get_weak_impacts();
+    nb_impacts = weak_impacts.size();
+    impact_periods.clear();
+    max_ends.clear();
+    for (idx_t idx = 0; idx < weak_impacts.size(); ++idx) {
+        const auto impact = weak_impacts[idx].lock();
+        if (! impact) { continue; }
+        for (const auto& application_period: impact->application_periods) {
+            if (application_period.is_null()) { continue; }
+            impact_periods.push_back({application_period.begin(), application_period.end(), idx});
+        }
+    }
+    std::sort(impact_periods.begin(), impact_periods.end(),
+              [](const ImpactPeriod& a, const ImpactPeriod& b) { return a.begin < b.begin; });
+    max_ends.reserve(impact_periods.size());
+    for (const auto& impact_period: impact_periods) {
+        max_ends.push_back(max_ends.empty() ? impact_period.end : std::max(max_ends.back(), impact_period.end));
+    }
+}
+
+boost::optional<boost::dynamic_bitset<>>
+TemporalIndex::get_vjs(const bt::time_period& period, size_t nb) const {
+    if (nb != nb_vjs || (beginning_date.is_not_a_date() && nb_vjs != 0)) { return boost::none; }
+    boost::dynamic_bitset<> res(nb_vjs);
+    if (vjs_by_day.empty()) { return res; } // no vehicle journey with stop times
+
+    for (bg::day_iterator it(period.begin().date()); it <= period.last().date(); ++it) {
+        const long day = (*it - beginning_date).days();
+        if (day < 0 || day >= long(vjs_by_day.size())) {
+            // out of the validity patterns, let the caller handle it
+            return boost::none;
+        }
+        const auto& vjs_of_the_day = vjs_by_day[day];
+        const bt::ptime day_start(*it);
+        const long from = std::max(0l, long((period.begin() - day_start).total_seconds()));
+        const long to = (period.end() - day_start).total_seconds();
+        // the vehicle journeys with from <= first departure < to
+        const auto begin = std::lower_bound(sorted_departures.begin(), sorted_departures.end(), from);
+        const auto end = std::lower_bound(begin, sorted_departures.end(), to);
+        if (begin == sorted_departures.begin() && end == sorted_departures.end()) {
+            res |= vjs_of_the_day;
+            continue;
+        }
+        for (auto i = begin - sorted_departures.begin(); i < end - sorted_departures.begin(); ++i) {
+            const idx_t vj_idx = vjs_by_departure[i];
+            if (vjs_of_the_day[vj_idx]) { res.set(vj_idx); }
+        }
+    }
+    return res;
+}
+
+boost::optional<boost::dynamic_bitset<>>
+TemporalIndex::get_impacts(const bt::time_period& period, size_t nb) const {
+    if (nb != nb_impacts) { return boost::none; }
+    boost::dynamic_bitset<> res(nb_impacts);
+    // the application periods beginning before the end of the period...
+    auto i = std::lower_bound(impact_periods.begin(), impact_periods.end(), period.end(),
+                              [](const ImpactPeriod& p, const bt::ptime& t) { return p.begin < t; })
+            - impact_periods.begin();
+    // ...and ending after its beginning. When all the previous ones end before, we can stop
+    while (i > 0 && max_ends[i - 1] > period.begin()) {
+        --i;
+        if (impact_periods[i].end > period.begin()) { res.set(impact_periods[i].impact_idx); }
+    }
+    return res;
+}
+
+}} //namespace navitia::type
@@ -0,0 +1,91 @@
+/* Copyright © 2001-2016, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/type_interfaces.h"
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/dynamic_bitset.hpp>
+#include <boost/optional.hpp>
+#include <vector>
+
+namespace navitia { namespace type {
+
+struct PT_Data;
+
+/** Index of the PT objects by time, to filter them on a period without scanning them
+  *
+  * For the vehicle journeys:
+  *  - for each day, the bitset of the vehicle journeys circulating this day
+  *    (from their base validity pattern),
+  *  - the vehicle journeys sorted by their first departure time,
+  *  so the vehicle journeys leaving in a period are, for each day of the period,
+  *  a slice of the sorted ones intersected with the bitset of the day.
+  *
+  * For the impacts, their application periods sorted by beginning with
+  * the running maximum of their ends: only the periods intersecting the
+  * requested period are visited.
+  *
+  * Like the RelationIndex, it is not serialized and rebuilt by Data::build_raptor.
+  */
+class TemporalIndex {
+    // beginning date of all the base validity patterns, not_a_date_time if they differ
+    boost::gregorian::date beginning_date;
+    std::vector<boost::dynamic_bitset<>> vjs_by_day;
+    std::vector<idx_t> vjs_by_departure;
+    std::vector<uint32_t> sorted_departures;
+    size_t nb_vjs = 0;
+
+    struct ImpactPeriod {
+        boost::posix_time::ptime begin;
+        boost::posix_time::ptime end;
+        idx_t impact_idx;
+    };
+    std::vector<ImpactPeriod> impact_periods; // sorted by begin
+    std::vector<boost::posix_time::ptime> max_ends; // max end of impact_periods[0..i]
+    size_t nb_impacts = 0;
+
+public:
+    void build(const PT_Data& pt_data);
+
+    /** The vehicle journeys leaving (first departure) during the period
+      *
+      * none if the index cannot answer (the data have changed since the
+      * build, or the period is out of the validity patterns)
+      */
+    boost::optional<boost::dynamic_bitset<>>
+    get_vjs(const boost::posix_time::time_period& period, size_t nb_vjs) const;
+
+    /// The impacts applied during the period, none if the impacts have changed since the build
+    boost::optional<boost::dynamic_bitset<>>
+    get_impacts(const boost::posix_time::time_period& period, size_t nb_impacts) const;
+};
+
+}} //namespace navitia::type
@@ -95,3 +95,30 @@ BOOST_AUTO_TEST_CASE(create_vj_test) {
     BOOST_CHECK_EQUAL(rt_vj->adapted_validity_pattern()->days, year("0000000" "0000000"));
     BOOST_CHECK_EQUAL(rt_vj->rt_validity_pattern()->days, year("0000000" "0000110"));
 }
+
+BOOST_AUTO_TEST_CASE(vjs_by_stop_point_test) {
+    namespace nt = navitia::type;
+
+    ed::builder b("20120614");
+    auto* vj_a = b.vj("A")("stop1", 8000, 8000)("stop2", 8100, 8100)("stop1", 8200, 8200).make();
+    auto* vj_b = b.vj("B")("stop2", 9000, 9000)("stop3", 9100, 9100).make();
+    b.finish();
+    auto& pt_data = *b.data->pt_data;
+    const auto& stop1 = *pt_data.stop_points_map.at("stop1");
+    const auto& stop2 = *pt_data.stop_points_map.at("stop2");
+    const auto& stop3 = *pt_data.stop_points_map.at("stop3");
+
+    // A stops twice at stop1 but is listed once
+    BOOST_CHECK(pt_data.get_vehicle_journeys(stop1) == std::vector<nt::VehicleJourney*>({vj_a}));
+    BOOST_CHECK(pt_data.get_vehicle_journeys(stop2) == std::vector<nt::VehicleJourney*>({vj_a, vj_b}));
+    BOOST_CHECK(pt_data.get_vehicle_journeys(stop3) == std::vector<nt::VehicleJourney*>({vj_b}));
+
+    // the new vjs are added to the index
+    auto* mvj = pt_data.meta_vjs.get_mut(navitia::Idx<nt::MetaVehicleJourney>(1));
+    auto sts = vj_b->stop_time_list;
+    sts.erase(sts.begin());
+    auto* rt_vj = mvj->create_discrete_vj("rt", nt::RTLevel::RealTime, *vj_b->base_validity_pattern(),
+                                                vj_b->route, sts, pt_data);
+    BOOST_CHECK(pt_data.get_vehicle_journeys(stop2) == std::vector<nt::VehicleJourney*>({vj_a, vj_b}));
+    BOOST_CHECK(pt_data.get_vehicle_journeys(stop3) == std::vector<nt::VehicleJourney*>({vj_b, rt_vj}));
+}
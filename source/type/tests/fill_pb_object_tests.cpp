@@ -201,3 +201,126 @@ BOOST_AUTO_TEST_CASE(ptref_indexes_test) {
     objs = navitia::ptref_indexes<nt::Contributor>(b.get<nt::Line>("B"), *b.data);
     BOOST_CHECK_EQUAL_RANGE(uris(objs), std::set<std::string>({"c1"}));
 }
+
+/*
+ * The sub objects already filled by a PbCreator are copied from its memo,
+ * they must be the same as a fresh filling and still add their impacts to the response
+ */
+BOOST_AUTO_TEST_CASE(memoized_sub_objects) {
+    ed::builder b("20150314");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8200, 8250);
+    b.vj("B")("stop1", 9000, 9050)("stop3", 9200, 9250);
+    b.generate_dummy_basis();
+    b.data->pt_data->index();
+    b.data->build_raptor();
+    b.data->build_uri();
+
+    const auto period = boost::posix_time::time_period("20150314T000000"_dt, "20150315T000000"_dt);
+    b.impact(nt::RTLevel::Adapted)
+            .uri("too_bad")
+            .publish(period)
+            .application_periods(period)
+            .severity(nt::disruption::Effect::SIGNIFICANT_DELAYS)
+            .on(nt::Type_e::StopArea, "stop1")
+            .msg("no luck");
+
+    const auto* sp1 = b.sps.find("stop1")->second;
+    const std::vector<const nt::StopPoint*> sps = {sp1, sp1};
+
+    navitia::PbCreator pb_creator(*b.data, "20150314T080000"_dt, period);
+    google::protobuf::RepeatedPtrField<pbnavitia::StopPoint> stop_points;
+    pb_creator.fill(sps, &stop_points, 1);
+    google::protobuf::RepeatedPtrField<pbnavitia::StopPoint> stop_points_depth_0;
+    pb_creator.fill(sps, &stop_points_depth_0, 0);
+
+    navitia::PbCreator other_creator(*b.data, "20150314T080000"_dt, period);
+    pbnavitia::StopPoint fresh_stop_point;
+    other_creator.fill(sp1, &fresh_stop_point, 1);
+
+    BOOST_REQUIRE_EQUAL(stop_points.size(), 2);
+    BOOST_CHECK_EQUAL(stop_points.Get(0).SerializeAsString(), fresh_stop_point.SerializeAsString());
+    BOOST_CHECK_EQUAL(stop_points.Get(1).SerializeAsString(), fresh_stop_point.SerializeAsString());
+    BOOST_REQUIRE_EQUAL(stop_points.Get(1).stop_area().impact_uris_size(), 1);
+    BOOST_CHECK_EQUAL(stop_points.Get(1).stop_area().impact_uris(0), "too_bad");
+
+    // the depth is part of the memo key
+    BOOST_REQUIRE_EQUAL(stop_points_depth_0.size(), 2);
+    BOOST_CHECK(! stop_points_depth_0.Get(1).has_stop_area());
+
+    const auto resp = pb_creator.get_response();
+    BOOST_REQUIRE_EQUAL(resp.impacts_size(), 1);
+    BOOST_CHECK_EQUAL(resp.impacts(0).uri(), "too_bad");
+}
+
+BOOST_AUTO_TEST_CASE(memoized_sub_objects_action_period) {
+    ed::builder b("20150314");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8200, 8250);
+    b.generate_dummy_basis();
+    b.data->pt_data->index();
+    b.data->build_raptor();
+    b.data->build_uri();
+
+    const auto morning = boost::posix_time::time_period("20150314T080000"_dt, "20150314T090000"_dt);
+    const auto evening = boost::posix_time::time_period("20150314T180000"_dt, "20150314T190000"_dt);
+    b.impact(nt::RTLevel::Adapted)
+            .uri("morning_only")
+            .publish(boost::posix_time::time_period("20150314T000000"_dt, "20150315T000000"_dt))
+            .application_periods(morning)
+            .severity(nt::disruption::Effect::SIGNIFICANT_DELAYS)
+            .on(nt::Type_e::StopArea, "stop1")
+            .msg("only in the morning");
+
+    const auto* sp1 = b.sps.find("stop1")->second;
+
+    // like for the sections of a journey, the action_period changes between two fillings
+    navitia::PbCreator pb_creator(*b.data, "20150314T080000"_dt, morning);
+    pbnavitia::StopPoint morning_stop_point;
+    pb_creator.fill(sp1, &morning_stop_point, 1);
+    pb_creator.action_period = evening;
+    pbnavitia::StopPoint evening_stop_point;
+    pb_creator.fill(sp1, &evening_stop_point, 1);
+
+    BOOST_REQUIRE_EQUAL(morning_stop_point.stop_area().impact_uris_size(), 1);
+    BOOST_CHECK_EQUAL(morning_stop_point.stop_area().impact_uris(0), "morning_only");
+    BOOST_CHECK_EQUAL(evening_stop_point.stop_area().impact_uris_size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(memoized_sub_objects_without_impacts) {
+    ed::builder b("20150314");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8200, 8250);
+    b.generate_dummy_basis();
+    b.data->pt_data->index();
+    b.data->build_raptor();
+    b.data->build_uri();
+
+    const auto morning = boost::posix_time::time_period("20150314T080000"_dt, "20150314T090000"_dt);
+    const auto evening = boost::posix_time::time_period("20150314T180000"_dt, "20150314T190000"_dt);
+    b.impact(nt::RTLevel::Adapted)
+            .uri("morning_only")
+            .publish(boost::posix_time::time_period("20150314T000000"_dt, "20150315T000000"_dt))
+            .application_periods(morning)
+            .severity(nt::disruption::Effect::SIGNIFICANT_DELAYS)
+            .on(nt::Type_e::StopArea, "stop1")
+            .msg("only in the morning");
+
+    auto* sp1 = b.sps.find("stop1")->second;
+    auto* sp2 = b.sps.find("stop2")->second;
+
+    navitia::PbCreator pb_creator(*b.data, "20150314T080000"_dt, morning);
+    pbnavitia::StopPoint stop_point;
+    pb_creator.fill(sp1, &stop_point, 1);
+    pb_creator.fill(sp2, &stop_point, 1);
+
+    // renamed behind the back of the memo, to see which fillings are copied
+    sp1->stop_area->name = "renamed stop1";
+    sp2->stop_area->name = "renamed stop2";
+    pb_creator.action_period = evening;
+    pbnavitia::StopPoint evening_sp1, evening_sp2;
+    pb_creator.fill(sp1, &evening_sp1, 1);
+    pb_creator.fill(sp2, &evening_sp2, 1);
+
+    // the stop area with an impact is filled again for the new period
+    BOOST_CHECK_EQUAL(evening_sp1.stop_area().name(), "renamed stop1");
+    // the one without impacts is copied whatever the period
+    BOOST_CHECK_EQUAL(evening_sp2.stop_area().name(), "stop2");
+}
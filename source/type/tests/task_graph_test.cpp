@@ -0,0 +1,96 @@
+/* Copyright © 2001-2015, Canal TP and/or its affiliates. All rights reserved.
+
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+Stay tuned using
+twitter @navitia
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE task_graph_test
+
+#include "type/task_graph.h"
+#include "tests/utils_test.h"
+#include "utils/logger.h"
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <mutex>
+
+namespace nt = navitia::type;
+
+struct logger_initialized {
+    logger_initialized()   { init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE( logger_initialized )
+
+BOOST_AUTO_TEST_CASE(task_graph_dependencies) {
+    nt::TaskGraph graph;
+    auto noop = []() {};
+    graph.add("a", {}, {"x"}, noop);
+    graph.add("b", {"x"}, {"y"}, noop); // read after write
+    graph.add("c", {"x"}, {"z"}, noop); // independent of b
+    graph.add("d", {}, {"x"}, noop);    // write after read and write
+    graph.add("e", {"y", "z"}, {}, noop);
+
+    BOOST_CHECK_EQUAL(graph.get_dependencies(0), std::vector<size_t>{});
+    BOOST_CHECK_EQUAL(graph.get_dependencies(1), std::vector<size_t>{0});
+    BOOST_CHECK_EQUAL(graph.get_dependencies(2), std::vector<size_t>{0});
+    BOOST_CHECK_EQUAL(graph.get_dependencies(3), (std::vector<size_t>{0, 1, 2}));
+    BOOST_CHECK_EQUAL(graph.get_dependencies(4), (std::vector<size_t>{1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(task_graph_run_in_order) {
+    for (size_t nb_threads: {1, 2, 8}) {
+        nt::TaskGraph graph;
+        std::mutex mutex;
+        std::vector<std::string> done;
+        auto task = [&](const std::string& name) {
+            return [&, name]() {
+                std::lock_guard<std::mutex> lock(mutex);
+                done.push_back(name);
+            };
+        };
+        graph.add("a", {}, {"x"}, task("a"));
+        graph.add("b", {"x"}, {"y"}, task("b"));
+        graph.add("c", {"x"}, {"z"}, task("c"));
+        graph.add("d", {"y", "z"}, {}, task("d"));
+
+        const auto reports = graph.run(nb_threads);
+        BOOST_REQUIRE_EQUAL(reports.size(), 4);
+        BOOST_CHECK_EQUAL(reports[3].name, "d");
+        BOOST_REQUIRE_EQUAL(done.size(), 4);
+        BOOST_CHECK_EQUAL(done.front(), "a");
+        BOOST_CHECK_EQUAL(done.back(), "d");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(task_graph_exception) {
+    nt::TaskGraph graph;
+    std::atomic<bool> dependent_run(false);
+    graph.add("a", {}, {"x"}, []() { throw std::runtime_error("bob"); });
+    graph.add("b", {"x"}, {}, [&]() { dependent_run = true; });
+    BOOST_CHECK_THROW(graph.run(4), std::runtime_error);
+    BOOST_CHECK(! dependent_run);
+}
@@ -38,9 +38,13 @@ www.navitia.io
 #include "type/datetime.h"
 #include "tests/utils_test.h"
 #include "type/meta_data.h"
+#include "type/pt_data.h"
+#include "georef/georef.h"
 
 #include <boost/geometry.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/filesystem.hpp>
+#include <sstream>
 
 namespace pt = boost::posix_time;
 namespace bg = boost::gregorian;
@@ -200,3 +204,125 @@ BOOST_AUTO_TEST_CASE(tz_handler_test) {
 
     BOOST_CHECK_EQUAL_RANGE(periods, build_dst_periods);
 }
+
+BOOST_AUTO_TEST_CASE(save_and_load_mapped_file) {
+    Data data;
+    auto* sa = new StopArea();
+    sa->uri = "sa:1";
+    sa->idx = 0;
+    data.pt_data->stop_areas.push_back(sa);
+
+    // from a buffer in memory
+    std::stringstream ss;
+    data.save(ss);
+    const auto buffer = ss.str();
+    Data from_buffer;
+    from_buffer.load(buffer.data(), buffer.size());
+    BOOST_REQUIRE_EQUAL(from_buffer.pt_data->stop_areas.size(), 1);
+    BOOST_CHECK_EQUAL(from_buffer.pt_data->stop_areas[0]->uri, "sa:1");
+
+    // from a memory mapped file
+    const auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    data.save(path.string());
+    Data from_file;
+    BOOST_CHECK(from_file.load(path.string()));
+    boost::filesystem::remove(path);
+    BOOST_REQUIRE_EQUAL(from_file.pt_data->stop_areas.size(), 1);
+    BOOST_CHECK_EQUAL(from_file.pt_data->stop_areas[0]->uri, "sa:1");
+
+    // a missing file is not loaded
+    Data missing;
+    BOOST_CHECK(! missing.load(path.string()));
+}
+
+BOOST_AUTO_TEST_CASE(proximity_lists_used_in_place) {
+    Data data;
+    auto* sa = new StopArea();
+    sa->uri = "sa:1";
+    sa->idx = 0;
+    sa->coord = GeographicalCoord(2.36, 48.84);
+    data.pt_data->stop_areas.push_back(sa);
+    data.pt_data->build_proximity_list();
+    const auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    data.save(path.string());
+
+    // the proximity lists of a mapped file are used in place
+    Data from_file;
+    BOOST_REQUIRE(from_file.load(path.string()));
+    boost::filesystem::remove(path);
+    const auto& items = from_file.pt_data->stop_area_proximity_list.items;
+    BOOST_CHECK(items.is_mapped());
+    BOOST_REQUIRE_EQUAL(items.size(), 1);
+    BOOST_CHECK_EQUAL(items[0].element, 0);
+    const auto found = from_file.pt_data->stop_area_proximity_list.find_within(sa->coord, 10);
+    BOOST_REQUIRE_EQUAL(found.size(), 1);
+    BOOST_CHECK_EQUAL(found[0].first, 0);
+
+    // a clone shares them
+    Data clone;
+    clone.clone_from(from_file);
+    BOOST_CHECK(clone.pt_data->stop_area_proximity_list.items.is_mapped());
+    BOOST_CHECK_EQUAL(clone.pt_data->stop_area_proximity_list.items.begin(), items.begin());
+
+    // they are copied from a buffer that may not outlive the data
+    std::stringstream ss;
+    data.save_sections(ss);
+    const auto buffer = ss.str();
+    Data from_buffer;
+    from_buffer.load(buffer.data(), buffer.size());
+    BOOST_CHECK(! from_buffer.pt_data->stop_area_proximity_list.items.is_mapped());
+    BOOST_CHECK_EQUAL(from_buffer.pt_data->stop_area_proximity_list.items.size(), 1);
+
+    // and modifying them makes them owned
+    from_file.pt_data->build_proximity_list();
+    BOOST_CHECK(! items.is_mapped());
+    BOOST_CHECK_EQUAL(items.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(save_and_load_sections) {
+    Data data;
+    auto* sa = new StopArea();
+    sa->uri = "sa:1";
+    sa->idx = 0;
+    data.pt_data->stop_areas.push_back(sa);
+    auto* sp = new StopPoint();
+    sp->uri = "sp:1";
+    sp->idx = 0;
+    sp->stop_area = sa;
+    sa->stop_point_list.push_back(sp);
+    data.pt_data->stop_points.push_back(sp);
+    auto* admin = new navitia::georef::Admin(8);
+    admin->uri = "admin:1";
+    admin->idx = 0;
+    admin->main_stop_areas.push_back(sa);
+    data.geo_ref->admins.push_back(admin);
+    sa->admin_list.push_back(admin);
+    sp->admin_list.push_back(admin);
+    data.meta->publisher_name = "canaltp";
+
+    std::stringstream ss;
+    data.save_sections(ss);
+    const auto buffer = ss.str();
+    Data loaded;
+    // load() recognizes the sectioned format
+    loaded.load(buffer.data(), buffer.size());
+    BOOST_CHECK_EQUAL(loaded.meta->publisher_name, "canaltp");
+    BOOST_REQUIRE_EQUAL(loaded.pt_data->stop_areas.size(), 1);
+    BOOST_REQUIRE_EQUAL(loaded.pt_data->stop_points.size(), 1);
+    BOOST_REQUIRE_EQUAL(loaded.geo_ref->admins.size(), 1);
+    const auto* loaded_sa = loaded.pt_data->stop_areas[0];
+    const auto* loaded_sp = loaded.pt_data->stop_points[0];
+    const auto* loaded_admin = loaded.geo_ref->admins[0];
+    BOOST_CHECK_EQUAL(loaded_sp->stop_area, loaded_sa);
+    // the links between the sections have been restored
+    BOOST_REQUIRE_EQUAL(loaded_sa->admin_list.size(), 1);
+    BOOST_CHECK_EQUAL(loaded_sa->admin_list[0], loaded_admin);
+    BOOST_REQUIRE_EQUAL(loaded_sp->admin_list.size(), 1);
+    BOOST_CHECK_EQUAL(loaded_sp->admin_list[0], loaded_admin);
+    BOOST_REQUIRE_EQUAL(loaded_admin->main_stop_areas.size(), 1);
+    BOOST_CHECK_EQUAL(loaded_admin->main_stop_areas[0], loaded_sa);
+
+    // a truncated file is detected before deserialization
+    Data truncated;
+    BOOST_CHECK_THROW(truncated.load(buffer.data(), buffer.size() / 2), navitia::exception);
+}
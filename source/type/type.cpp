@@ -406,6 +406,7 @@ VJ* MetaVehicleJourney::impl_create_vj(const std::string& uri,
     // inserting the vj in the model
     pt_data.vehicle_journeys.push_back(ret);
     pt_data.vehicle_journeys_map[ret->uri] = ret;
+    pt_data.add_to_vjs_by_stop_point(ret);
     if (route) {
         get_vjs<VJ>(route).push_back(ret);
     }
@@ -695,7 +696,7 @@ Indexes Line::get(Type_e type, const PT_Data& data) const {
         break;
     case Type_e::PhysicalMode: return indexes(physical_mode_list);
     case Type_e::Company: return indexes(company_list);
-    case Type_e::Network: result.insert(network->idx); break;
+    case Type_e::Network: if (network) { result.insert(network->idx); } break;
     case Type_e::Route: return indexes(route_list);
     case Type_e::Calendar: return indexes(calendar_list);
     case Type_e::LineGroup: return indexes(line_group_list);
@@ -745,7 +746,7 @@ Indexes LineGroup::get(Type_e type, const PT_Data&) const {
 Indexes Route::get(Type_e type, const PT_Data& data) const {
     Indexes result;
     switch(type) {
-    case Type_e::Line: result.insert(line->idx); break;
+    case Type_e::Line: if (line) { result.insert(line->idx); } break;
     case Type_e::VehicleJourney:
         for_each_vehicle_journey([&](const VehicleJourney& vj) {
                 result.insert(vj.idx); //TODO use bulk insert ?
@@ -790,9 +791,9 @@ VehicleJourney::get_impacts() const {
 Indexes VehicleJourney::get(Type_e type, const PT_Data& data) const {
     Indexes result;
     switch(type) {
-    case Type_e::Route: result.insert(route->idx); break;
-    case Type_e::Company: result.insert(company->idx); break;
-    case Type_e::PhysicalMode: result.insert(physical_mode->idx); break;
+    case Type_e::Route: if (route) { result.insert(route->idx); } break;
+    case Type_e::Company: if (company) { result.insert(company->idx); } break;
+    case Type_e::PhysicalMode: if (physical_mode) { result.insert(physical_mode->idx); } break;
     case Type_e::ValidityPattern: result.insert(base_validity_pattern()->idx); break;
     case Type_e::MetaVehicleJourney: result.insert(meta_vj->idx); break;
     case Type_e::Dataset: if (dataset) { result.insert(dataset->idx); } break;
@@ -809,7 +810,7 @@ DiscreteVehicleJourney::~DiscreteVehicleJourney() {}
 Indexes StopPoint::get(Type_e type, const PT_Data& data) const {
     Indexes result;
     switch(type) {
-    case Type_e::StopArea: result.insert(stop_area->idx); break;
+    case Type_e::StopArea: if (stop_area) { result.insert(stop_area->idx); } break;
     case Type_e::Connection:
     case Type_e::StopPointConnection:
         for (const StopPointConnection* stop_cnx : stop_point_connection_list)
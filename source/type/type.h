@@ -99,6 +99,11 @@ public:
             const boost::posix_time::ptime& current_time) const;
 
     std::vector<boost::shared_ptr<disruption::Impact>> get_impacts() const;
+    /// true if there is an impact, whatever its periods
+    bool has_impacts() const {
+        return std::any_of(impacts.begin(), impacts.end(),
+                           [](const boost::weak_ptr<disruption::Impact>& i) { return ! i.expired(); });
+    }
 
     void remove_impact(const boost::shared_ptr<disruption::Impact>& impact) {
         auto it = std::find_if(impacts.begin(), impacts.end(),
@@ -160,8 +165,10 @@ struct StopPoint : public Header, Nameable, hasProperties, HasMessages {
         // during serialization and deserialization.
         //
         // stop_point_connection_list is managed by StopPointConnection
+        //
+        // admin_list is a link to the geo_ref, managed by Data::CrossReferences
         ar & uri & label & name & stop_area & coord & fare_zone & is_zonal & idx & platform_code
-            & admin_list & _properties & impacts & dataset_list;
+            & _properties & impacts & dataset_list;
     }
 
     StopPoint(): fare_zone(0),  stop_area(nullptr), network(nullptr) {}
@@ -254,7 +261,8 @@ struct StopArea : public Header, Nameable, hasProperties, HasMessages {
     std::string timezone;
 
     template<class Archive> void serialize(Archive & ar, const unsigned int ) {
-        ar & idx & label & uri & name & coord & stop_point_list & admin_list
+        // admin_list is a link to the geo_ref, managed by Data::CrossReferences
+        ar & idx & label & uri & name & coord & stop_point_list
             & _properties & wheelchair_boarding & impacts & visible
             & timezone;
     }